@@ -0,0 +1,665 @@
+// ==========================
+//  AURUM HEADLESS RENDER BENCH
+//
+//  gcc -O2 aurum_bench.c aurum_tile.c aurum_layout.c aurum_overlay.c -o aurum_bench `pkg-config --cflags --libs gdk-3.0 pangocairo` -lm
+//  ./aurum_bench [-n FRAMES] [-p FORMAT] [-r WxH]... [-g GIF_DIR] [-o OUT.json] [-c BASE.json]
+//
+//  Runs the kiosk's renderers against cairo image surfaces, with no
+//  window, display or serial controller:
+//    tile     one token's three tiles (aurum_tile_render), per token set
+//    frame    background + three cached tiles + ticker, per composited frame
+//    ticker   ticker strip render once, then the scrolling band blit
+//    gif      overlay frames: the cached pre-scaled blit and the live scale
+//  at 720p, 1080p and 4K (or each -r), for several token strings and
+//  number fonts. Every case reports per-frame time percentiles and the
+//  mallocs per frame to stdout and to OUT.json (default aurum_bench.json),
+//  one case per line. With -c, p50 times are compared against an earlier
+//  run and the exit status is 1 if any case got more than 25% slower.
+// ==========================
+
+#include "aurum_tile.h"
+#include "aurum_layout.h"
+#include "aurum_overlay.h"
+
+#include <gdk/gdk.h>
+
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===================== ALLOCATION COUNTING =====================
+/*
+ * malloc and friends are interposed for the whole process, so the counts
+ * include what cairo, pixman, pango and glib allocate on our behalf.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *p, size_t size);
+extern void *__libc_memalign(size_t align, size_t size);
+extern void __libc_free(void *p);
+
+static atomic_ulong alloc_count;
+static atomic_ulong alloc_bytes;
+
+static void count_alloc(size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&alloc_bytes, size, memory_order_relaxed);
+}
+
+void *malloc(size_t size)
+{
+    count_alloc(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size)
+{
+    count_alloc(n * size);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size)
+{
+    count_alloc(size);
+    return __libc_realloc(p, size);
+}
+
+int posix_memalign(void **out, size_t align, size_t size)
+{
+    count_alloc(size);
+    void *p = __libc_memalign(align, size);
+    if (!p)
+        return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+void *aligned_alloc(size_t align, size_t size)
+{
+    count_alloc(size);
+    return __libc_memalign(align, size);
+}
+
+void *memalign(size_t align, size_t size)
+{
+    count_alloc(size);
+    return __libc_memalign(align, size);
+}
+
+void free(void *p)
+{
+    __libc_free(p);
+}
+
+// ===================== TIMING AND RESULTS =====================
+#define MAX_RESULTS 256
+#define MAX_SIZES 8
+#define REGRESSION 1.25
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+typedef struct {
+    char name[128];
+    int frames;
+    double p50_us, p90_us, p99_us, max_us, mean_us;
+    double allocs;              // per frame
+    double alloc_kb;            // per frame
+} Result;
+
+static Result results[MAX_RESULTS];
+static int nresults = 0;
+
+// One timed case: per-frame samples plus the allocation counters around them
+typedef struct {
+    int64_t *ns;
+    int n, cap;
+    unsigned long allocs0, bytes0;
+} Sampler;
+
+static void sampler_begin(Sampler *s, int frames)
+{
+    s->ns = __libc_malloc(sizeof(int64_t) * (size_t)frames);
+    s->n = 0;
+    s->cap = frames;
+    s->allocs0 = atomic_load(&alloc_count);
+    s->bytes0 = atomic_load(&alloc_bytes);
+}
+
+static void sampler_add(Sampler *s, int64_t ns)
+{
+    if (s->n < s->cap)
+        s->ns[s->n++] = ns;
+}
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples, in microseconds
+static double pct_us(const int64_t *sorted, int n, double p)
+{
+    int k = (int)(p / 100.0 * n + 0.5);
+    if (k < 1) k = 1;
+    if (k > n) k = n;
+    return sorted[k - 1] / 1000.0;
+}
+
+static void sampler_end(Sampler *s, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void sampler_end(Sampler *s, const char *fmt, ...)
+{
+    unsigned long allocs = atomic_load(&alloc_count) - s->allocs0;
+    unsigned long bytes = atomic_load(&alloc_bytes) - s->bytes0;
+    Result *r = nresults < MAX_RESULTS ? &results[nresults++] : NULL;
+    va_list ap;
+
+    if (!r || s->n == 0) {
+        __libc_free(s->ns);
+        return;
+    }
+
+    va_start(ap, fmt);
+    vsnprintf(r->name, sizeof(r->name), fmt, ap);
+    va_end(ap);
+
+    int64_t total = 0;
+    for (int i = 0; i < s->n; i++)
+        total += s->ns[i];
+    qsort(s->ns, (size_t)s->n, sizeof(int64_t), cmp_i64);
+
+    r->frames = s->n;
+    r->p50_us = pct_us(s->ns, s->n, 50);
+    r->p90_us = pct_us(s->ns, s->n, 90);
+    r->p99_us = pct_us(s->ns, s->n, 99);
+    r->max_us = s->ns[s->n - 1] / 1000.0;
+    r->mean_us = total / 1000.0 / s->n;
+    r->allocs = (double)allocs / s->n;
+    r->alloc_kb = bytes / 1024.0 / s->n;
+    __libc_free(s->ns);
+
+    printf("%-58s %9.1f %9.1f %9.1f %9.1f %8.1f %10.1f\n", r->name,
+           r->p50_us, r->p90_us, r->p99_us, r->max_us, r->allocs, r->alloc_kb);
+    fflush(stdout);
+}
+
+// ===================== TOKEN TILES =====================
+static const char *const bench_tokens[] = { "7", "42", "88", NULL };
+static const char *const bench_fonts[] = {
+    NULL,                       // the kiosk's own styles
+    "DejaVu Sans Bold",
+    "Arial Bold",
+};
+#define NTOKENS (int)(sizeof(bench_tokens) / sizeof(bench_tokens[0]))
+#define NFONTS (int)(sizeof(bench_fonts) / sizeof(bench_fonts[0]))
+
+static void styles_with_font(AurumTileStyle out[AURUM_TILE_SLOTS], const char *font)
+{
+    memcpy(out, aurum_tile_styles, sizeof(AurumTileStyle) * AURUM_TILE_SLOTS);
+    if (font)
+        for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+            out[s].num_font = font;
+}
+
+// What the render worker does per token: all three slots at screen size
+static void bench_tiles(AurumTileRenderer *r, const AurumLayout *l, int frames)
+{
+    for (int f = 0; f < NFONTS; f++) {
+        AurumTileStyle styles[AURUM_TILE_SLOTS];
+        styles_with_font(styles, bench_fonts[f]);
+        for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+            aurum_tile_prepare(r, &styles[s], 1, l->tile[s].width, l->tile[s].height);
+
+        for (int t = 0; t < NTOKENS; t++) {
+            Sampler smp;
+            sampler_begin(&smp, frames);
+            for (int i = 0; i < frames; i++) {
+                int64_t t0 = now_ns();
+                for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+                    cairo_surface_destroy(aurum_tile_render(r, l->tile[s].width, l->tile[s].height,
+                                                            bench_tokens[t], &styles[s], 1));
+                sampler_add(&smp, now_ns() - t0);
+            }
+            sampler_end(&smp, "tile/%dx%d/%s/%s", l->width, l->height,
+                        styles[AURUM_TILE_CURRENT].num_font,
+                        bench_tokens[t] ? bench_tokens[t] : "--");
+        }
+    }
+}
+
+// ===================== TICKER =====================
+// ticker_render_strip, including the layout compositor_layout builds
+static cairo_surface_t *ticker_strip(const AurumLayout *l, cairo_format_t format)
+{
+    cairo_surface_t *scratch = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+    cairo_t *scr = cairo_create(scratch);
+    PangoLayout *layout = pango_cairo_create_layout(scr);
+
+    aurum_text_font(layout, AURUM_TICKER_FONT, l->ticker_font_size);
+    pango_layout_set_text(layout, AURUM_TICKER_TEXT, -1);
+    cairo_surface_t *strip = aurum_ticker_strip(layout, l->ticker_band.height, format);
+
+    g_object_unref(layout);
+    cairo_destroy(scr);
+    cairo_surface_destroy(scratch);
+    return strip;
+}
+
+// ticker_draw at the strip position for frame i of a 60 Hz scroll
+static void ticker_blit(cairo_t *cr, const AurumLayout *l, cairo_surface_t *strip, int i)
+{
+    int sw = cairo_image_surface_get_width(strip);
+    double x = l->ticker_band.width -
+               fmod(i * AURUM_TICKER_SPEED_PX_S / 60.0, l->ticker_band.width + sw);
+
+    aurum_ticker_blit(cr, &l->ticker_band, strip, x);
+}
+
+static void bench_ticker(const AurumLayout *l, cairo_format_t format, cairo_t *screen, int frames)
+{
+    Sampler smp;
+
+    sampler_begin(&smp, frames);
+    for (int i = 0; i < frames; i++) {
+        int64_t t0 = now_ns();
+        cairo_surface_destroy(ticker_strip(l, format));
+        sampler_add(&smp, now_ns() - t0);
+    }
+    sampler_end(&smp, "ticker-strip/%dx%d", l->width, l->height);
+
+    cairo_surface_t *strip = ticker_strip(l, format);
+    sampler_begin(&smp, frames);
+    for (int i = 0; i < frames; i++) {
+        int64_t t0 = now_ns();
+        ticker_blit(screen, l, strip, i);
+        cairo_surface_flush(cairo_get_target(screen));
+        sampler_add(&smp, now_ns() - t0);
+    }
+    sampler_end(&smp, "ticker-scroll/%dx%d", l->width, l->height);
+    cairo_surface_destroy(strip);
+}
+
+// ===================== FULL FRAME =====================
+// compositor_draw with every tile cached: what each vsync costs
+static void bench_frame(AurumTileRenderer *r, const AurumLayout *l, cairo_format_t format,
+                        cairo_t *screen, int frames)
+{
+    cairo_surface_t *tiles[AURUM_TILE_SLOTS];
+    cairo_surface_t *strip = ticker_strip(l, format);
+    Sampler smp;
+
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++) {
+        aurum_tile_prepare(r, &aurum_tile_styles[s], 1, l->tile[s].width, l->tile[s].height);
+        tiles[s] = aurum_tile_render(r, l->tile[s].width, l->tile[s].height, "88",
+                                     &aurum_tile_styles[s], 1);
+    }
+
+    sampler_begin(&smp, frames);
+    for (int i = 0; i < frames; i++) {
+        int64_t t0 = now_ns();
+        aurum_set_source_hex(screen, AURUM_SCREEN_BG_HEX);
+        cairo_paint(screen);
+        for (int s = 0; s < AURUM_TILE_SLOTS; s++) {
+            cairo_save(screen);
+            cairo_rectangle(screen, l->tile[s].x, l->tile[s].y,
+                            l->tile[s].width, l->tile[s].height);
+            cairo_clip(screen);
+            cairo_set_source_surface(screen, tiles[s], l->tile[s].x, l->tile[s].y);
+            cairo_paint(screen);
+            cairo_restore(screen);
+        }
+        ticker_blit(screen, l, strip, i);
+        cairo_surface_flush(cairo_get_target(screen));
+        sampler_add(&smp, now_ns() - t0);
+    }
+    sampler_end(&smp, "frame/%dx%d", l->width, l->height);
+
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+        cairo_surface_destroy(tiles[s]);
+    cairo_surface_destroy(strip);
+}
+
+// ===================== GIF OVERLAYS =====================
+#define GIF_MAX_FRAMES 64
+
+static const char *const bench_gifs[] = {
+    "Please_wait.gif", "gameover.gif", "congratulations1.gif",
+};
+
+typedef struct {
+    const char *file;
+    GdkPixbuf *frames[GIF_MAX_FRAMES];
+    int nframes;
+} Gif;
+
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS   // the iter API still takes GTimeVal
+
+// Decode the first GIF_MAX_FRAMES frames at the GIF's own delays (a short
+// GIF loops round to fill them, as playback would)
+static int gif_load(Gif *g, const char *dir, const char *file)
+{
+    char path[512];
+    GError *error = NULL;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+    GdkPixbufAnimation *anim = gdk_pixbuf_animation_new_from_file(path, &error);
+    if (!anim) {
+        fprintf(stderr, "skipping %s: %s\n", path, error ? error->message : "unknown");
+        if (error) g_error_free(error);
+        return -1;
+    }
+
+    GTimeVal origin, at;
+    g_get_current_time(&origin);
+    at = origin;
+    GdkPixbufAnimationIter *iter = gdk_pixbuf_animation_get_iter(anim, &origin);
+
+    g->file = file;
+    g->nframes = 0;
+    while (g->nframes < GIF_MAX_FRAMES) {
+        g->frames[g->nframes++] = gdk_pixbuf_copy(gdk_pixbuf_animation_iter_get_pixbuf(iter));
+        int delay = gdk_pixbuf_animation_iter_get_delay_time(iter);
+        if (delay <= 0)
+            break;                  // static image
+        g_time_val_add(&at, (glong)delay * 1000);
+        gdk_pixbuf_animation_iter_advance(iter, &at);
+    }
+    g_object_unref(iter);
+    g_object_unref(anim);
+    return 0;
+}
+
+G_GNUC_END_IGNORE_DEPRECATIONS
+
+static void gif_free(Gif *g)
+{
+    for (int k = 0; k < g->nframes; k++)
+        g_object_unref(g->frames[k]);
+    g->nframes = 0;
+}
+
+static void bench_gif(const Gif *g, const AurumLayout *l, cairo_format_t format,
+                      cairo_t *screen, int frames)
+{
+    AurumFrameCache cache = { 0 };
+    Sampler smp;
+
+    aurum_frame_cache_fit(&cache, g->nframes, gdk_pixbuf_get_width(g->frames[0]),
+                          gdk_pixbuf_get_height(g->frames[0]), l->width, l->height, format);
+    aurum_frame_cache_alloc(&cache);
+
+    // Pre-scaling, one source frame per sample
+    sampler_begin(&smp, g->nframes);
+    for (int k = 0; k < g->nframes; k++) {
+        int64_t t0 = now_ns();
+        aurum_frame_cache_fill(&cache, k, g->frames[k]);
+        sampler_add(&smp, now_ns() - t0);
+    }
+    sampler_end(&smp, "gif-prescale/%dx%d/%s", l->width, l->height, g->file);
+
+    // overlay_draw, cached: side bars and a straight blit
+    sampler_begin(&smp, frames);
+    for (int i = 0; i < frames; i++) {
+        int64_t t0 = now_ns();
+        aurum_overlay_draw_frame(screen, cache.frames[i % g->nframes], l->width, l->height);
+        cairo_surface_flush(cairo_get_target(screen));
+        sampler_add(&smp, now_ns() - t0);
+    }
+    sampler_end(&smp, "gif-cached/%dx%d/%s", l->width, l->height, g->file);
+
+    // overlay_draw, live: convert and scale the pixbuf on every frame
+    sampler_begin(&smp, frames);
+    for (int i = 0; i < frames; i++) {
+        int64_t t0 = now_ns();
+        aurum_overlay_draw_live(screen, g->frames[i % g->nframes], l->width, l->height);
+        cairo_surface_flush(cairo_get_target(screen));
+        sampler_add(&smp, now_ns() - t0);
+    }
+    sampler_end(&smp, "gif-live/%dx%d/%s", l->width, l->height, g->file);
+
+    aurum_frame_cache_clear(&cache);
+}
+
+// ===================== OUTPUT =====================
+static void json_string(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static int write_json(const char *path, cairo_format_t format, int frames)
+{
+    FILE *f = fopen(path, "w");
+    struct utsname u;
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    uname(&u);
+
+    fprintf(f, "{\"host\":");
+    json_string(f, u.nodename);
+    fprintf(f, ",\"machine\":");
+    json_string(f, u.machine);
+    fprintf(f, ",\"time\":%lld,\"format\":\"%s\",\"frames\":%d,\n\"results\":[\n",
+            (long long)time(NULL), aurum_tile_format_name(format), frames);
+
+    // One case per line, so runs diff and grep cleanly
+    for (int i = 0; i < nresults; i++) {
+        const Result *r = &results[i];
+        fprintf(f, "{\"name\":");
+        json_string(f, r->name);
+        fprintf(f, ",\"frames\":%d,\"p50_us\":%.1f,\"p90_us\":%.1f,\"p99_us\":%.1f,"
+                   "\"max_us\":%.1f,\"mean_us\":%.1f,\"allocs\":%.2f,\"alloc_kb\":%.2f}%s\n",
+                r->frames, r->p50_us, r->p90_us, r->p99_us, r->max_us, r->mean_us,
+                r->allocs, r->alloc_kb, i + 1 < nresults ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    return fclose(f);
+}
+
+// Header field "key":"value" from write_json's first line, or "" if absent
+static void json_header_field(const char *line, const char *key, char *out, size_t cap)
+{
+    char pat[32];
+    snprintf(pat, sizeof(pat), "\"%s\":\"", key);
+    const char *p = strstr(line, pat);
+    size_t n = 0;
+
+    if (p)
+        for (p += strlen(pat); *p && *p != '"' && n + 1 < cap; p++)
+            out[n++] = *p;
+    out[n] = '\0';
+}
+
+/*
+ * Reads back our own write_json lines; returns cases that regressed, -1 on
+ * error. Numbers only compare within one surface format and one kind of
+ * machine: a format mismatch, or a baseline with no case in common with
+ * this run, is an error rather than a pass.
+ */
+static int compare(const char *path, cairo_format_t format)
+{
+    FILE *f = fopen(path, "r");
+    char line[1024];
+    int regressed = 0, matched = 0;
+    struct utsname u;
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    printf("\nagainst %s (p50, >%.0f%% slower is a regression):\n", path,
+           (REGRESSION - 1) * 100);
+
+    char base_format[32], base_machine[sizeof(u.machine)];
+    if (!fgets(line, sizeof(line), f))
+        line[0] = '\0';
+    json_header_field(line, "format", base_format, sizeof(base_format));
+    json_header_field(line, "machine", base_machine, sizeof(base_machine));
+    if (strcmp(base_format, aurum_tile_format_name(format)) != 0) {
+        fprintf(stderr, "%s was taken with %s surfaces, this run uses %s\n", path,
+                base_format[0] ? base_format : "unknown", aurum_tile_format_name(format));
+        fclose(f);
+        return -1;
+    }
+    uname(&u);
+    if (strcmp(base_machine, u.machine) != 0)
+        printf("  note: baseline machine %s, this one %s\n",
+               base_machine[0] ? base_machine : "unknown", u.machine);
+
+    while (fgets(line, sizeof(line), f)) {
+        char name[128];
+        const char *p = strstr(line, "\"p50_us\":");
+        double base;
+
+        if (sscanf(line, "{\"name\":\"%127[^\"]\"", name) != 1 || !p ||
+            sscanf(p + 9, "%lf", &base) != 1)
+            continue;
+        for (int i = 0; i < nresults; i++) {
+            if (strcmp(results[i].name, name) != 0)
+                continue;
+            double ratio = base > 0 ? results[i].p50_us / base : 1;
+            matched++;
+            if (ratio > REGRESSION) {
+                regressed++;
+                printf("  REGRESSED %-48s %9.1f -> %9.1f us (x%.2f)\n",
+                       name, base, results[i].p50_us, ratio);
+            }
+        }
+    }
+    fclose(f);
+    printf("  %d cases compared, %d regressed\n", matched, regressed);
+    if (matched == 0) {
+        fprintf(stderr, "%s has no case in common with this run\n", path);
+        return -1;
+    }
+    return regressed;
+}
+
+// ===================== MAIN =====================
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [-n FRAMES] [-p argb32|rgb24] [-r WxH]... "
+                    "[-g GIF_DIR] [-o OUT.json] [-c BASE.json]\n", argv0);
+}
+
+int main(int argc, char *argv[])
+{
+    int sizes[MAX_SIZES][2];
+    int nsizes = 0;
+    int frames = 100;
+    cairo_format_t format = CAIRO_FORMAT_RGB24;
+    const char *gif_dir = ".";
+    const char *out = "aurum_bench.json";
+    const char *baseline = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:p:r:g:o:c:")) != -1) {
+        switch (opt) {
+        case 'n':
+            frames = atoi(optarg);
+            break;
+        case 'p':
+            if (!aurum_tile_parse_format(optarg, &format)) {
+                fprintf(stderr, "unknown pixel format '%s'\n", optarg);
+                return 2;
+            }
+            break;
+        case 'r':
+            if (nsizes == MAX_SIZES ||
+                sscanf(optarg, "%dx%d", &sizes[nsizes][0], &sizes[nsizes][1]) != 2 ||
+                sizes[nsizes][0] < 320 || sizes[nsizes][1] < 240) {
+                usage(argv[0]);
+                return 2;
+            }
+            nsizes++;
+            break;
+        case 'g': gif_dir = optarg; break;
+        case 'o': out = optarg; break;
+        case 'c': baseline = optarg; break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 1 || optind != argc) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (nsizes == 0) {
+        static const int defaults[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+        memcpy(sizes, defaults, sizeof(defaults));
+        nsizes = 3;
+    }
+
+    Gif gifs[sizeof(bench_gifs) / sizeof(bench_gifs[0])];
+    int ngifs = 0;
+    for (size_t i = 0; i < sizeof(bench_gifs) / sizeof(bench_gifs[0]); i++)
+        if (gif_load(&gifs[ngifs], gif_dir, bench_gifs[i]) == 0)
+            ngifs++;
+
+    AurumTileRenderer r;
+    aurum_tile_renderer_init(&r);
+    r.format = format;
+    aurum_tile_prepare(&r, aurum_tile_styles, AURUM_TILE_SLOTS, 0, 0);
+
+    printf("%d frames per case, %s surfaces\n\n", frames, aurum_tile_format_name(format));
+    printf("%-58s %9s %9s %9s %9s %8s %10s\n", "case", "p50 us", "p90 us",
+           "p99 us", "max us", "allocs", "alloc KB");
+
+    for (int i = 0; i < nsizes; i++) {
+        AurumLayout l;
+        aurum_layout_compute(&l, &aurum_layout_default_ratios, sizes[i][0], sizes[i][1]);
+
+        // The window surface is XRGB whatever the cache format
+        cairo_surface_t *target = cairo_image_surface_create(CAIRO_FORMAT_RGB24, l.width, l.height);
+        cairo_t *screen = cairo_create(target);
+
+        bench_tiles(&r, &l, frames);
+        bench_frame(&r, &l, format, screen, frames);
+        bench_ticker(&l, format, screen, frames);
+        for (int g = 0; g < ngifs; g++)
+            bench_gif(&gifs[g], &l, format, screen, frames);
+
+        cairo_destroy(screen);
+        cairo_surface_destroy(target);
+    }
+
+    aurum_tile_renderer_free(&r);
+    for (int g = 0; g < ngifs; g++)
+        gif_free(&gifs[g]);
+
+    if (write_json(out, format, frames) < 0)
+        return 1;
+    printf("\nwrote %d cases to %s\n", nresults, out);
+
+    if (baseline) {
+        int regressed = compare(baseline, format);
+        if (regressed != 0)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// ==========================
+//  AURUM SCREEN LAYOUT AND TICKER
+// ==========================
+
+#include "aurum_layout.h"
+
+#include <stdio.h>
+
+const AurumLayoutRatios aurum_layout_default_ratios = { 0.11, 0.85, 0.71, 0.65 };
+
+// ===================== LAYOUT =====================
+void aurum_layout_compute(AurumLayout *l, const AurumLayoutRatios *r, int W, int H)
+{
+    l->width = W;
+    l->height = H;
+
+    l->top = (cairo_rectangle_int_t){ 0, 0, W, (int)(H * r->top) };
+
+    int y0 = l->top.height;
+    int below = H - y0;
+    int tokens_h = (int)(below * r->tokens);
+    int cur_w = (int)(W * r->current);
+    int prev_h = (int)(tokens_h * r->previous);
+
+    l->tile[AURUM_TILE_CURRENT]   = (cairo_rectangle_int_t){ 0, y0, cur_w, tokens_h };
+    l->tile[AURUM_TILE_PREVIOUS]  = (cairo_rectangle_int_t){ cur_w, y0, W - cur_w, prev_h };
+    l->tile[AURUM_TILE_PRECEDING] = (cairo_rectangle_int_t){ cur_w, y0 + prev_h,
+                                                             W - cur_w, tokens_h - prev_h };
+    l->ticker = (cairo_rectangle_int_t){ 0, y0 + tokens_h, W, H - (y0 + tokens_h) };
+
+    // Ticker text sits in the bottom band of the ticker area
+    l->ticker_band = l->ticker;
+    if (l->ticker_band.height > AURUM_TICKER_HEIGHT) {
+        l->ticker_band.y += l->ticker_band.height - AURUM_TICKER_HEIGHT;
+        l->ticker_band.height = AURUM_TICKER_HEIGHT;
+    }
+
+    // Text sizes follow the area below the top label, as the paned layout did
+    l->top_font_size = (int)(below * 0.08 * 0.9 * PANGO_SCALE);
+    l->ticker_font_size = (int)(below * 0.042 * 0.9 * PANGO_SCALE);
+}
+
+// ===================== TEXT =====================
+void aurum_set_source_hex(cairo_t *cr, const char *hex)
+{
+    unsigned r, g, b;
+    if (hex && sscanf(hex, "#%02x%02x%02x", &r, &g, &b) == 3)
+        cairo_set_source_rgb(cr, r / 255.0, g / 255.0, b / 255.0);
+}
+
+void aurum_text_font(PangoLayout *layout, const char *family, int size)
+{
+    PangoFontDescription *fd = pango_font_description_new();
+    pango_font_description_set_family(fd, family);
+    pango_font_description_set_weight(fd, PANGO_WEIGHT_BOLD);
+    pango_font_description_set_size(fd, size);
+    pango_layout_set_font_description(layout, fd);
+    pango_font_description_free(fd);
+}
+
+// ===================== TICKER =====================
+cairo_surface_t *aurum_ticker_strip(PangoLayout *layout, int band_h,
+                                    cairo_format_t format)
+{
+    int tw, th;
+
+    if (band_h <= 0)
+        return NULL;
+
+    pango_layout_get_pixel_size(layout, &tw, &th);
+    cairo_surface_t *strip = cairo_image_surface_create(format, tw > 0 ? tw : 1, band_h);
+    cairo_t *cr = cairo_create(strip);
+    aurum_set_source_hex(cr, AURUM_SCREEN_BG_HEX);
+    cairo_paint(cr);
+    aurum_set_source_hex(cr, AURUM_TICKER_HEX);
+    cairo_move_to(cr, 0, (band_h - th) / 2);
+    pango_cairo_show_layout(cr, layout);
+    cairo_destroy(cr);
+    cairo_surface_flush(strip);
+    return strip;
+}
+
+void aurum_ticker_blit(cairo_t *cr, const cairo_rectangle_int_t *band,
+                       cairo_surface_t *strip, double x)
+{
+    int sw = cairo_image_surface_get_width(strip);
+
+    cairo_save(cr);
+    cairo_rectangle(cr, band->x, band->y, band->width, band->height);
+    cairo_clip(cr);
+    cairo_set_source_surface(cr, strip, band->x + x, band->y);
+    cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_PAD);
+    cairo_rectangle(cr, band->x + x, band->y, sw, band->height);
+    cairo_fill(cr);
+    cairo_restore(cr);
+}
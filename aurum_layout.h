@@ -0,0 +1,63 @@
+// ==========================
+//  AURUM SCREEN LAYOUT AND TICKER
+//  Where the top label, the three token tiles and the ticker go for a
+//  window size and the AURUM_RATIO_* values, and the ticker's text strip,
+//  rendered once and then scrolled as a blit. Cairo and pango only, so
+//  the headless benches lay out and draw exactly what the kiosk does.
+// ==========================
+
+#ifndef AURUM_LAYOUT_H
+#define AURUM_LAYOUT_H
+
+#include <cairo.h>
+#include <pango/pangocairo.h>
+
+#include "aurum_tile.h"
+
+#define AURUM_SCREEN_BG_HEX     "#FFDAB9"
+#define AURUM_TICKER_TEXT       "Aurum Smart Tech"
+#define AURUM_TICKER_FONT       "Arial"
+#define AURUM_TICKER_HEX        "#2F4F4F"
+#define AURUM_TICKER_HEIGHT     60      // text band at the bottom of the ticker area
+#define AURUM_TICKER_SPEED_PX_S 66.7    // the old 2 px per 30 ms step
+
+typedef struct {
+    double top;       // top label height / window height
+    double tokens;    // token area height / height below the top label
+    double current;   // current tile width / window width
+    double previous;  // previous tile height / token area height
+} AurumLayoutRatios;
+
+// 0.11, 0.85, 0.71, 0.65: what aurum.txt documents as the defaults
+extern const AurumLayoutRatios aurum_layout_default_ratios;
+
+// Rectangles are cairo_rectangle_int_t, which is what GdkRectangle is
+typedef struct {
+    int width, height;
+    cairo_rectangle_int_t top;
+    cairo_rectangle_int_t tile[AURUM_TILE_SLOTS];
+    cairo_rectangle_int_t ticker;       // everything below the tiles
+    cairo_rectangle_int_t ticker_band;  // where the scrolling text runs
+    int top_font_size;                  // pango units
+    int ticker_font_size;
+} AurumLayout;
+
+void aurum_layout_compute(AurumLayout *l, const AurumLayoutRatios *r, int W, int H);
+
+// "#RRGGBB" as the source colour; anything else leaves the source alone
+void aurum_set_source_hex(cairo_t *cr, const char *hex);
+
+// Bold family at size (pango units) as the layout's font
+void aurum_text_font(PangoLayout *layout, const char *family, int size);
+
+// Opaque strip of the layout's text on the screen background, band_h
+// high and as wide as the text. NULL if band_h <= 0.
+cairo_surface_t *aurum_ticker_strip(PangoLayout *layout, int band_h,
+                                    cairo_format_t format);
+
+// Strip with its left edge x pixels into the band (band width: just off
+// the right edge), clipped to the band
+void aurum_ticker_blit(cairo_t *cr, const cairo_rectangle_int_t *band,
+                       cairo_surface_t *strip, double x);
+
+#endif
@@ -0,0 +1,383 @@
+// ==========================
+//  AURUM MPV IPC CLIENT
+// ==========================
+
+#include "aurum_mpv.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ===================== CONNECTION =====================
+static void schedule_retry(AurumMpv *m, int64_t now_us)
+{
+    m->retry_at_us = now_us + m->backoff_us;
+    m->backoff_us *= 2;
+    if (m->backoff_us > AURUM_MPV_BACKOFF_MAX_US)
+        m->backoff_us = AURUM_MPV_BACKOFF_MAX_US;
+}
+
+static void report(AurumMpv *m, const AurumMpvRequest *r, AurumMpvStatus st,
+                   int64_t now_us, const char *line)
+{
+    int64_t rtt = now_us - r->queued_us;
+
+    if (st == AURUM_MPV_REPLY_OK || st == AURUM_MPV_REPLY_ERROR) {
+        m->replies++;
+        m->total_rtt_us += rtt;
+        if (rtt > m->max_rtt_us)
+            m->max_rtt_us = rtt;
+    }
+    if (st != AURUM_MPV_REPLY_OK)
+        m->errors++;
+
+    if (m->reply)
+        m->reply(r->id, r->name, st, rtt, line, m->user);
+}
+
+// Established connection lost: everything in flight or queued is failed
+static void drop_connection(AurumMpv *m, int64_t now_us)
+{
+    AurumMpvRequest failed[AURUM_MPV_MAX_INFLIGHT];
+    unsigned nfailed = m->ninflight;
+
+    close(m->fd);
+    m->fd = -1;
+    m->connecting = 0;
+    m->out_len = 0;
+    m->in_len = 0;
+    m->disconnects++;
+
+    memcpy(failed, m->inflight, nfailed * sizeof(failed[0]));
+    m->ninflight = 0;
+    schedule_retry(m, now_us);
+
+    // Callbacks may queue new commands, so report after the reset
+    for (unsigned i = 0; i < nfailed; i++)
+        report(m, &failed[i], AURUM_MPV_REPLY_DISCONNECTED, now_us, NULL);
+}
+
+// Connect attempt failed before anything was sent: keep the queue
+static void connect_failed(AurumMpv *m, int64_t now_us)
+{
+    if (m->fd >= 0)
+        close(m->fd);
+    m->fd = -1;
+    m->connecting = 0;
+    schedule_retry(m, now_us);
+}
+
+static void flush_out(AurumMpv *m, int64_t now_us);
+
+static void connected(AurumMpv *m, int64_t now_us)
+{
+    m->connecting = 0;
+    m->backoff_us = AURUM_MPV_BACKOFF_MIN_US;
+    flush_out(m, now_us);
+}
+
+static void try_connect(AurumMpv *m, int64_t now_us)
+{
+    struct sockaddr_un addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, m->path, sizeof(addr.sun_path) - 1);
+
+    m->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m->fd < 0) {
+        schedule_retry(m, now_us);
+        return;
+    }
+
+    if (connect(m->fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        connected(m, now_us);
+    } else if (errno == EINPROGRESS || errno == EAGAIN) {
+        m->connecting = 1;      // finish on POLLOUT
+    } else {
+        connect_failed(m, now_us);   // mpv not up yet: ENOENT / ECONNREFUSED
+    }
+}
+
+// ===================== WRITE =====================
+static void flush_out(AurumMpv *m, int64_t now_us)
+{
+    while (m->out_len > 0) {
+        ssize_t n = send(m->fd, m->out, m->out_len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                drop_connection(m, now_us);
+            return;
+        }
+        memmove(m->out, m->out + n, m->out_len - (size_t)n);
+        m->out_len -= (size_t)n;
+    }
+}
+
+// Append s as a JSON string literal; returns new length or 0 if it won't fit
+static size_t json_string(char *buf, size_t len, size_t cap, const char *s)
+{
+    if (len + 1 >= cap)
+        return 0;
+    buf[len++] = '"';
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (len + 7 >= cap)
+            return 0;
+        if (c == '"' || c == '\\') {
+            buf[len++] = '\\';
+            buf[len++] = (char)c;
+        } else if (c < 0x20) {
+            len += (size_t)snprintf(buf + len, cap - len, "\\u%04x", c);
+        } else {
+            buf[len++] = (char)c;
+        }
+    }
+    buf[len++] = '"';
+    return len;
+}
+
+unsigned aurum_mpv_command(AurumMpv *m, const char *const argv[], int64_t now_us)
+{
+    char line[1024];
+    size_t len = 0;
+
+    if (m->ninflight >= AURUM_MPV_MAX_INFLIGHT) {
+        m->errors++;
+        return 0;
+    }
+
+    unsigned id = m->next_id++;
+    if (m->next_id == 0)
+        m->next_id = 1;
+
+    len = (size_t)snprintf(line, sizeof(line), "{\"command\":[");
+    for (int i = 0; argv[i]; i++) {
+        if (i > 0)
+            line[len++] = ',';
+        len = json_string(line, len, sizeof(line) - 32, argv[i]);
+        if (len == 0) {
+            m->errors++;
+            return 0;
+        }
+    }
+    len += (size_t)snprintf(line + len, sizeof(line) - len,
+                            "],\"request_id\":%u}\n", id);
+
+    if (m->out_len + len > sizeof(m->out)) {
+        m->errors++;
+        return 0;
+    }
+    memcpy(m->out + m->out_len, line, len);
+    m->out_len += len;
+
+    AurumMpvRequest *r = &m->inflight[m->ninflight++];
+    r->id = id;
+    r->queued_us = now_us;
+    r->bytes = len;
+    snprintf(r->name, sizeof(r->name), "%s", argv[0] ? argv[0] : "");
+    m->sent++;
+
+    if (m->fd >= 0 && !m->connecting)
+        flush_out(m, now_us);
+    return id;
+}
+
+// ===================== READ =====================
+// Pointer to the value of "key" in a flat JSON object line, or NULL
+static const char *json_value(const char *line, const char *key)
+{
+    char pat[32];
+    snprintf(pat, sizeof(pat), "\"%s\"", key);
+
+    const char *p = strstr(line, pat);
+    if (!p)
+        return NULL;
+    p += strlen(pat);
+    while (*p == ' ') p++;
+    if (*p != ':')
+        return NULL;
+    p++;
+    while (*p == ' ') p++;
+    return p;
+}
+
+static void handle_line(AurumMpv *m, const char *line, int64_t now_us)
+{
+    const char *v = json_value(line, "request_id");
+
+    if (!v) {
+        if (json_value(line, "event") && m->reply)
+            m->reply(0, "event", AURUM_MPV_REPLY_EVENT, 0, line, m->user);
+        return;
+    }
+
+    unsigned id = (unsigned)strtoul(v, NULL, 10);
+    for (unsigned i = 0; i < m->ninflight; i++) {
+        if (m->inflight[i].id != id)
+            continue;
+
+        AurumMpvRequest r = m->inflight[i];
+        memmove(&m->inflight[i], &m->inflight[i + 1],
+                (m->ninflight - i - 1) * sizeof(m->inflight[0]));
+        m->ninflight--;
+
+        const char *err = json_value(line, "error");
+        int ok = err && strncmp(err, "\"success\"", 9) == 0;
+        report(m, &r, ok ? AURUM_MPV_REPLY_OK : AURUM_MPV_REPLY_ERROR, now_us, line);
+        return;
+    }
+    // Reply to a request that already timed out: nothing to do
+}
+
+static void read_replies(AurumMpv *m, int64_t now_us)
+{
+    for (;;) {
+        if (m->in_len >= sizeof(m->in) - 1)
+            m->in_len = 0;      // over-long line; we never ask for big data
+
+        ssize_t n = read(m->fd, m->in + m->in_len, sizeof(m->in) - 1 - m->in_len);
+        if (n == 0) {
+            drop_connection(m, now_us);
+            return;
+        }
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                drop_connection(m, now_us);
+            return;
+        }
+        m->in_len += (size_t)n;
+
+        char *start = m->in;
+        char *nl;
+        while ((nl = memchr(start, '\n', m->in_len - (size_t)(start - m->in))) != NULL) {
+            *nl = '\0';
+            handle_line(m, start, now_us);
+            if (m->fd < 0)
+                return;     // a callback closed the client
+            start = nl + 1;
+        }
+        m->in_len -= (size_t)(start - m->in);
+        memmove(m->in, start, m->in_len);
+    }
+}
+
+// ===================== PUBLIC API =====================
+void aurum_mpv_init(AurumMpv *m, const char *path,
+                    AurumMpvReplyFn reply, void *user)
+{
+    memset(m, 0, sizeof(*m));
+    snprintf(m->path, sizeof(m->path), "%s", path ? path : AURUM_MPV_SOCKET);
+    m->fd = -1;
+    m->next_id = 1;
+    m->backoff_us = AURUM_MPV_BACKOFF_MIN_US;
+    m->reply = reply;
+    m->user = user;
+}
+
+int aurum_mpv_fd(const AurumMpv *m)
+{
+    return m->fd;
+}
+
+int aurum_mpv_wants_write(const AurumMpv *m)
+{
+    return m->fd >= 0 && (m->connecting || m->out_len > 0);
+}
+
+int aurum_mpv_idle(const AurumMpv *m)
+{
+    return m->fd >= 0 && !m->connecting && m->out_len == 0 && m->ninflight == 0;
+}
+
+void aurum_mpv_handle(AurumMpv *m, int readable, int writable, int64_t now_us)
+{
+    if (m->fd < 0)
+        return;
+
+    if (m->connecting) {
+        if (!readable && !writable)
+            return;
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(m->fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+            connect_failed(m, now_us);
+            return;
+        }
+        connected(m, now_us);
+        if (m->fd < 0)
+            return;
+    }
+
+    if (writable && m->out_len > 0)
+        flush_out(m, now_us);
+    if (readable && m->fd >= 0)
+        read_replies(m, now_us);
+}
+
+void aurum_mpv_tick(AurumMpv *m, int64_t now_us)
+{
+    if (m->fd < 0 && now_us >= m->retry_at_us)
+        try_connect(m, now_us);
+
+    // Requests are queued in time order, so the expired ones are a prefix
+    unsigned expired = 0;
+    while (expired < m->ninflight &&
+           now_us - m->inflight[expired].queued_us > AURUM_MPV_TIMEOUT_US)
+        expired++;
+    if (expired == 0)
+        return;
+
+    AurumMpvRequest timed_out[AURUM_MPV_MAX_INFLIGHT];
+    memcpy(timed_out, m->inflight, expired * sizeof(timed_out[0]));
+    memmove(m->inflight, m->inflight + expired,
+            (m->ninflight - expired) * sizeof(m->inflight[0]));
+    m->ninflight -= expired;
+
+    // Not connected: nothing was sent, so drop their lines instead of
+    // replaying stale commands when mpv comes back
+    if (m->fd < 0 || m->connecting) {
+        size_t drop = 0;
+        for (unsigned i = 0; i < expired; i++)
+            drop += timed_out[i].bytes;
+        memmove(m->out, m->out + drop, m->out_len - drop);
+        m->out_len -= drop;
+    }
+
+    for (unsigned i = 0; i < expired; i++)
+        report(m, &timed_out[i], AURUM_MPV_REPLY_TIMEOUT, now_us, NULL);
+}
+
+int64_t aurum_mpv_next_deadline(const AurumMpv *m)
+{
+    int64_t due = -1;
+
+    if (m->fd < 0)
+        due = m->retry_at_us;
+    if (m->ninflight > 0) {
+        // Oldest first; tick expires a request strictly after the timeout
+        int64_t expires = m->inflight[0].queued_us + AURUM_MPV_TIMEOUT_US + 1;
+        if (due < 0 || expires < due)
+            due = expires;
+    }
+    return due;
+}
+
+void aurum_mpv_close(AurumMpv *m)
+{
+    if (m->fd >= 0)
+        close(m->fd);
+    m->fd = -1;
+    m->connecting = 0;
+    m->out_len = 0;
+    m->in_len = 0;
+    m->ninflight = 0;
+}
@@ -0,0 +1,106 @@
+// ==========================
+//  AURUM MPV IPC CLIENT
+//  One persistent non-blocking connection to mpv's JSON IPC socket.
+//  Commands are pipelined with request_id; replies are matched as they
+//  arrive and every request is timed. The caller owns the event loop:
+//  watch aurum_mpv_fd() for aurum_mpv_wants_write() / readable, call
+//  aurum_mpv_handle(), and call aurum_mpv_tick() at aurum_mpv_next_deadline().
+// ==========================
+
+#ifndef AURUM_MPV_H
+#define AURUM_MPV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AURUM_MPV_SOCKET          "/tmp/mpv.sock"
+#define AURUM_MPV_MAX_INFLIGHT    64
+#define AURUM_MPV_OUT_MAX         8192
+#define AURUM_MPV_IN_MAX          4096
+#define AURUM_MPV_TIMEOUT_US      2000000
+#define AURUM_MPV_BACKOFF_MIN_US  100000
+#define AURUM_MPV_BACKOFF_MAX_US  5000000
+
+typedef enum {
+    AURUM_MPV_REPLY_OK,         // "error":"success"
+    AURUM_MPV_REPLY_ERROR,      // mpv rejected the command
+    AURUM_MPV_REPLY_TIMEOUT,
+    AURUM_MPV_REPLY_DISCONNECTED,
+    AURUM_MPV_REPLY_EVENT,      // unsolicited {"event":...}; id is 0
+} AurumMpvStatus;
+
+/*
+ * Called for each reply, failure or event.
+ *   line    the raw JSON line (NULL for timeout / disconnect)
+ *   rtt_us  time since aurum_mpv_command() queued the request
+ */
+typedef void (*AurumMpvReplyFn)(unsigned id, const char *name,
+                                AurumMpvStatus status, int64_t rtt_us,
+                                const char *line, void *user);
+
+typedef struct {
+    unsigned id;
+    int64_t queued_us;
+    size_t bytes;               // length of its JSON line in out[]
+    char name[24];              // first command word, for logs
+} AurumMpvRequest;
+
+typedef struct {
+    char path[108];
+    int fd;                     // -1 while disconnected
+    int connecting;             // non-blocking connect() in progress
+
+    char out[AURUM_MPV_OUT_MAX];
+    size_t out_len;
+    char in[AURUM_MPV_IN_MAX];
+    size_t in_len;
+
+    AurumMpvRequest inflight[AURUM_MPV_MAX_INFLIGHT];
+    unsigned ninflight;
+    unsigned next_id;
+
+    int64_t retry_at_us;
+    int64_t backoff_us;
+
+    AurumMpvReplyFn reply;
+    void *user;
+
+    // Stats
+    unsigned long sent;
+    unsigned long replies;
+    unsigned long errors;       // error replies, timeouts and drops
+    unsigned long disconnects;  // established connections lost
+    int64_t total_rtt_us;
+    int64_t max_rtt_us;
+} AurumMpv;
+
+// path NULL = AURUM_MPV_SOCKET. Does not connect; the first tick does.
+void aurum_mpv_init(AurumMpv *m, const char *path,
+                    AurumMpvReplyFn reply, void *user);
+
+/*
+ * Queue {"command":[argv...],"request_id":N}. argv is NULL-terminated.
+ * Sent immediately if connected, otherwise on the next connect.
+ * Returns the request id, or 0 if the queue is full.
+ */
+unsigned aurum_mpv_command(AurumMpv *m, const char *const argv[], int64_t now_us);
+
+int aurum_mpv_fd(const AurumMpv *m);
+int aurum_mpv_wants_write(const AurumMpv *m);
+
+// Connected, nothing queued, nothing awaiting a reply: no tick needed
+int aurum_mpv_idle(const AurumMpv *m);
+
+// Service the socket after poll(); readable/writable as reported
+void aurum_mpv_handle(AurumMpv *m, int readable, int writable, int64_t now_us);
+
+// Reconnect when the backoff has expired and time out stale requests
+void aurum_mpv_tick(AurumMpv *m, int64_t now_us);
+
+// When aurum_mpv_tick() next has work: the reconnect while disconnected,
+// or the oldest request's timeout. -1 when only the socket needs watching.
+int64_t aurum_mpv_next_deadline(const AurumMpv *m);
+
+void aurum_mpv_close(AurumMpv *m);
+
+#endif
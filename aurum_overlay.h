@@ -0,0 +1,45 @@
+// ==========================
+//  AURUM OVERLAY FRAMES
+//  A GIF overlay's frames scaled once to the window height into cairo
+//  surfaces and drawn centred between black bars, plus the live path
+//  that scales a GdkPixbuf on every draw when they do not fit the cache.
+//  Decoding and timing stay with the caller.
+// ==========================
+
+#ifndef AURUM_OVERLAY_H
+#define AURUM_OVERLAY_H
+
+#include <gdk/gdk.h>
+#include <stddef.h>
+
+typedef struct {
+    cairo_format_t format;
+    int nframes;
+    int w, h;                   // every scaled frame's size
+    cairo_surface_t **frames;   // NULL = not cached; entries scaled on first use
+} AurumFrameCache;
+
+/*
+ * Drop any cached frames, then size the cache for nframes src_w x src_h
+ * frames in a W x H window: full height, width to match (at most W).
+ * Nothing is allocated until aurum_frame_cache_alloc().
+ */
+void aurum_frame_cache_fit(AurumFrameCache *c, int nframes, int src_w, int src_h,
+                           int W, int H, cairo_format_t format);
+
+// Bytes the cache holds once every frame is scaled
+size_t aurum_frame_cache_bytes(const AurumFrameCache *c);
+
+void aurum_frame_cache_alloc(AurumFrameCache *c);
+void aurum_frame_cache_clear(AurumFrameCache *c);
+
+// Frame k, scaled from src over black the first time (src NULL: black)
+cairo_surface_t *aurum_frame_cache_fill(AurumFrameCache *c, int k, GdkPixbuf *src);
+
+// A cached frame centred in W x H with black bars: a straight blit
+void aurum_overlay_draw_frame(cairo_t *cr, cairo_surface_t *frame, int W, int H);
+
+// An unscaled source frame, scaled to the height on the fly (NULL: black)
+void aurum_overlay_draw_live(cairo_t *cr, GdkPixbuf *frame, int W, int H);
+
+#endif
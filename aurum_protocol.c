@@ -0,0 +1,244 @@
+// ==========================
+//  AURUM SERIAL PROTOCOL PARSER
+//  Bytes -> fields (offsets into one line buffer) -> rule table -> event
+// ==========================
+
+#include "aurum_protocol.h"
+
+#include <string.h>
+
+#define TTY5 AURUM_DIALECT_TTY5
+#define STM  AURUM_DIALECT_STM
+
+// ===================== RULE TABLE =====================
+const AurumRule aurum_rules[] = {
+    /* ---------- both builds ---------- */
+    { TTY5 | STM, "$S", "*", "*", 5, AURUM_EV_SNAPSHOT, AURUM_CTL_NONE, 1, 3 },
+
+    /* ---------- tty5 build ---------- */
+    { TTY5, ":01", "1", "*",  3, AURUM_EV_TOKEN,   AURUM_CTL_NONE,         2, 1 },
+    { TTY5, ":00", "3", "6A", 3, AURUM_EV_CONTROL, AURUM_CTL_GAME_OVER,   -1, 0 },
+    { TTY5, ":00", "3", "7A", 3, AURUM_EV_CONTROL, AURUM_CTL_CONGRATS,    -1, 0 },
+    { TTY5, ":00", "3", "7B", 3, AURUM_EV_CONTROL, AURUM_CTL_EXIT_OVERLAY,-1, 0 },
+    { TTY5, ":00", "3", "5A", 3, AURUM_EV_CONTROL, AURUM_CTL_TICKER_HIDE, -1, 0 },
+    { TTY5, ":00", "3", "5B", 3, AURUM_EV_CONTROL, AURUM_CTL_TICKER_SHOW, -1, 0 },
+
+    /* ---------- STM32 flash build ---------- */
+    { STM,  ":*",  "1", "*",  3, AURUM_EV_TOKEN,   AURUM_CTL_NONE,         2, 1 },
+    { STM,  ":*",  "3", "*",  3, AURUM_EV_CONTROL, AURUM_CTL_ROLLING,     -1, 0 },
+    { STM,  ":*",  NULL, NULL,1, AURUM_EV_NONE,    AURUM_CTL_NONE,        -1, 0 },
+    { STM,  "$N",  NULL, NULL,1, AURUM_EV_SLOTS,   AURUM_CTL_NONE,         1, 3 },
+    { STM,  "$M",  "T1", NULL,2, AURUM_EV_CONTROL, AURUM_CTL_MAIN_SCREEN, -1, 0 },
+    { STM,  "$M",  "P1", NULL,2, AURUM_EV_CONTROL, AURUM_CTL_PLEASE_WAIT, -1, 0 },
+    { STM,  "$M",  "G1", NULL,2, AURUM_EV_CONTROL, AURUM_CTL_GAME_OVER,   -1, 0 },
+    { STM,  "$M",  "GS", NULL,2, AURUM_EV_CONTROL, AURUM_CTL_GAME_START,  -1, 0 },
+    { STM,  "$M",  "C1", NULL,2, AURUM_EV_CONTROL, AURUM_CTL_CONGRATS,    -1, 0 },
+    { STM,  "$M",  NULL, NULL,1, AURUM_EV_NONE,    AURUM_CTL_NONE,        -1, 0 },
+    { STM,  "*",   NULL, NULL,1, AURUM_EV_BARE_TOKEN, AURUM_CTL_NONE,      0, 1 },
+};
+
+const size_t aurum_rule_count = sizeof(aurum_rules) / sizeof(aurum_rules[0]);
+
+#undef TTY5
+#undef STM
+
+// ===================== FIELD MATCHING =====================
+static int field_matches(const AurumParser *p, unsigned idx, const char *pat)
+{
+    if (!pat)
+        return 1;
+    if (idx >= p->nfields)
+        return 0;
+
+    const char *f = p->line + p->field_off[idx];
+    size_t flen = p->field_len[idx];
+
+    if (pat[0] == '*' && pat[1] == '\0')
+        return 1;
+    if (pat[0] == ':' && pat[1] == '*' && pat[2] == '\0')
+        return f[0] == ':';
+
+    size_t plen = strlen(pat);
+    return plen == flen && memcmp(f, pat, flen) == 0;
+}
+
+static void copy_token(char *dst, const AurumParser *p, unsigned idx)
+{
+    size_t n = p->field_len[idx];
+    if (n > AURUM_TOKEN_MAX - 1)
+        n = AURUM_TOKEN_MAX - 1;
+    memcpy(dst, p->line + p->field_off[idx], n);
+    dst[n] = '\0';
+}
+
+// Decimal 1..90 without sign or leading zeros; -1 otherwise
+static int field_number(const AurumParser *p, unsigned idx)
+{
+    const char *f = p->line + p->field_off[idx];
+    size_t n = p->field_len[idx];
+    int v = 0;
+
+    if (n == 0 || n > 2 || f[0] == '0')
+        return -1;
+    for (size_t i = 0; i < n; i++) {
+        if (f[i] < '0' || f[i] > '9')
+            return -1;
+        v = v * 10 + (f[i] - '0');
+    }
+    return (v >= 1 && v <= AURUM_NUMBER_MAX) ? v : -1;
+}
+
+// "$S cur prev pre count n1..ncount" -> drawn set; 0 if malformed
+static int parse_snapshot(const AurumParser *p, AurumEvent *ev)
+{
+    const char *f = p->line + p->field_off[4];
+    size_t n = p->field_len[4];
+    unsigned count = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (f[i] < '0' || f[i] > '9' || i >= 3)
+            return 0;
+        count = count * 10 + (unsigned)(f[i] - '0');
+    }
+    if (n == 0 || count > AURUM_NUMBER_MAX || p->nfields != 5 + count)
+        return 0;
+
+    ev->drawn[0] = ev->drawn[1] = 0;
+    for (unsigned i = 0; i < count; i++) {
+        int v = field_number(p, 5 + i);
+        if (v < 0 || aurum_drawn_test(ev->drawn, v))
+            return 0;
+        aurum_drawn_set(ev->drawn, v);
+    }
+    ev->ndrawn = (int)count;
+    return 1;
+}
+
+// ===================== LINE DISPATCH =====================
+static void dispatch_line(AurumParser *p)
+{
+    p->lines++;
+
+    for (size_t i = 0; i < aurum_rule_count; i++) {
+        const AurumRule *r = &aurum_rules[i];
+
+        if (!(r->dialects & p->dialects))
+            continue;
+        if (p->nfields < r->min_fields)
+            continue;
+        if (!field_matches(p, 0, r->f0) ||
+            !field_matches(p, 1, r->f1) ||
+            !field_matches(p, 2, r->f2))
+            continue;
+
+        if (r->type == AURUM_EV_NONE)
+            return;
+
+        AurumEvent ev;
+        ev.type = r->type;
+        ev.control = r->control;
+        ev.ntokens = 0;
+        ev.drawn[0] = ev.drawn[1] = 0;
+        ev.ndrawn = 0;
+
+        if (r->type == AURUM_EV_SNAPSHOT && !parse_snapshot(p, &ev)) {
+            p->unknown++;   // never apply a partial snapshot
+            return;
+        }
+
+        if (r->token_field >= 0) {
+            for (int t = 0; t < r->max_tokens; t++) {
+                unsigned idx = (unsigned)(r->token_field + t);
+                if (idx < p->nfields)
+                    copy_token(ev.tokens[t], p, idx);
+                else
+                    memcpy(ev.tokens[t], "--", 3);   // "$N" with missing slots
+            }
+            ev.ntokens = r->max_tokens;
+        }
+
+        p->events++;
+        if (p->emit)
+            p->emit(&ev, p->user);
+        return;
+    }
+
+    p->unknown++;
+}
+
+// ===================== PUBLIC API =====================
+void aurum_parser_reset(AurumParser *p)
+{
+    p->len = 0;
+    p->nfields = 0;
+    p->in_field = 0;
+    p->overflow = 0;
+}
+
+void aurum_parser_init(AurumParser *p, unsigned dialects,
+                       AurumEventFn emit, void *user)
+{
+    memset(p, 0, sizeof(*p));
+    p->dialects = dialects;
+    p->emit = emit;
+    p->user = user;
+}
+
+void aurum_parser_feed(AurumParser *p, const char *data, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        char c = data[i];
+
+        if (c == '\r' || c == '\n') {
+            if (p->overflow)
+                p->overflows++;
+            else if (p->nfields > 0)
+                dispatch_line(p);
+            aurum_parser_reset(p);
+            continue;
+        }
+
+        if (p->overflow)
+            continue;   // discard the rest of an over-long line
+
+        if (c == ' ') {
+            p->in_field = 0;
+            continue;
+        }
+
+        if (p->len >= AURUM_LINE_MAX) {
+            p->overflow = 1;
+            continue;
+        }
+
+        if (!p->in_field) {
+            if (p->nfields >= AURUM_FIELDS_MAX) {
+                p->overflow = 1;
+                continue;
+            }
+            p->field_off[p->nfields] = p->len;
+            p->field_len[p->nfields] = 0;
+            p->nfields++;
+            p->in_field = 1;
+        }
+
+        p->line[p->len++] = c;
+        p->field_len[p->nfields - 1]++;
+    }
+}
+
+const char *aurum_control_name(AurumControl c)
+{
+    switch (c) {
+    case AURUM_CTL_GAME_OVER:    return "GAME_OVER";
+    case AURUM_CTL_CONGRATS:     return "CONGRATS";
+    case AURUM_CTL_EXIT_OVERLAY: return "EXIT_OVERLAY";
+    case AURUM_CTL_TICKER_HIDE:  return "TICKER_HIDE";
+    case AURUM_CTL_TICKER_SHOW:  return "TICKER_SHOW";
+    case AURUM_CTL_ROLLING:      return "ROLLING";
+    case AURUM_CTL_MAIN_SCREEN:  return "MAIN_SCREEN";
+    case AURUM_CTL_PLEASE_WAIT:  return "PLEASE_WAIT";
+    case AURUM_CTL_GAME_START:   return "GAME_START";
+    default:                     return "NONE";
+    }
+}
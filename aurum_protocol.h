@@ -0,0 +1,136 @@
+// ==========================
+//  AURUM SERIAL PROTOCOL PARSER
+//  Incremental, table-driven, no allocation.
+//  Shared by token_display (tty5 build) and main_withstm_flash.c
+// ==========================
+
+#ifndef AURUM_PROTOCOL_H
+#define AURUM_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AURUM_TOKEN_MAX   16    // "90", "--" plus slack, NUL included
+#define AURUM_LINE_MAX    512   // longest accepted line (bytes)
+#define AURUM_FIELDS_MAX  100   // space separated fields per line
+#define AURUM_NUMBER_MAX  90    // tambola numbers are 1..90
+
+// ===================== DIALECTS =====================
+// Firmware variants speak different message sets; a parser accepts the
+// union of the dialects it is initialised with.
+typedef enum {
+    AURUM_DIALECT_TTY5 = 1u << 0,   // ":01 1 <token>", ":00 3 6A/7A/7B/5A/5B"
+    AURUM_DIALECT_STM  = 1u << 1,   // ":xx 1 <token>", "$N cur prev pre", "$M T1/P1/G1/GS/C1"
+} AurumDialect;
+
+// ===================== EVENTS =====================
+typedef enum {
+    AURUM_EV_NONE,          // recognised but carries no action
+    AURUM_EV_TOKEN,         // new draw: tokens[0]
+    AURUM_EV_BARE_TOKEN,    // STM fallback: whole line is a token (hides overlays)
+    AURUM_EV_SLOTS,         // "$N": tokens[0..2] = current, previous, preceding
+    AURUM_EV_SNAPSHOT,      // "$S": slots + full drawn list, applied atomically
+    AURUM_EV_CONTROL,       // screen / overlay command in .control
+} AurumEventType;
+
+typedef enum {
+    AURUM_CTL_NONE,
+    AURUM_CTL_GAME_OVER,    // ":00 3 6A"  / "$M G1"
+    AURUM_CTL_CONGRATS,     // ":00 3 7A"  / "$M C1"
+    AURUM_CTL_EXIT_OVERLAY, // ":00 3 7B"
+    AURUM_CTL_TICKER_HIDE,  // ":00 3 5A"
+    AURUM_CTL_TICKER_SHOW,  // ":00 3 5B"
+    AURUM_CTL_ROLLING,      // ":xx 3 ..." (STM: start rolling)
+    AURUM_CTL_MAIN_SCREEN,  // "$M T1"
+    AURUM_CTL_PLEASE_WAIT,  // "$M P1"
+    AURUM_CTL_GAME_START,   // "$M GS"
+} AurumControl;
+
+typedef struct {
+    AurumEventType type;
+    AurumControl control;
+    int ntokens;
+    char tokens[3][AURUM_TOKEN_MAX];
+
+    // AURUM_EV_SNAPSHOT only: bit n set when number n (1..90) is drawn
+    uint64_t drawn[2];
+    int ndrawn;
+} AurumEvent;
+
+/*
+ * Snapshot frame (both dialects), one line:
+ *   $S <cur> <prev> <pre> <count> <n1> <n2> ... <ncount>
+ * Slots use "--" when empty. The line is rejected unless exactly
+ * <count> numbers follow and each is a distinct 1..90.
+ */
+static inline int aurum_drawn_test(const uint64_t drawn[2], int n)
+{
+    return (drawn[n >> 6] >> (n & 63)) & 1;
+}
+
+static inline void aurum_drawn_set(uint64_t drawn[2], int n)
+{
+    drawn[n >> 6] |= (uint64_t)1 << (n & 63);
+}
+
+// Called once per recognised line; the event is only valid during the call
+typedef void (*AurumEventFn)(const AurumEvent *ev, void *user);
+
+// ===================== REGISTRATION TABLE =====================
+/*
+ * A rule matches the first three fields of a line. Field patterns:
+ *   NULL   -> anything (field may be missing)
+ *   "*"    -> any present field
+ *   ":*"   -> any field starting with ':'
+ *   other  -> exact match
+ * Rules are tried in order; the first match wins. Fields named by
+ * token_field onwards are copied into the event's tokens.
+ */
+typedef struct {
+    unsigned dialects;
+    const char *f0;
+    const char *f1;
+    const char *f2;
+    unsigned min_fields;
+    AurumEventType type;
+    AurumControl control;
+    int token_field;        // first field copied into tokens, -1 for none
+    int max_tokens;
+} AurumRule;
+
+extern const AurumRule aurum_rules[];
+extern const size_t aurum_rule_count;
+
+// ===================== PARSER =====================
+typedef struct {
+    unsigned dialects;
+    AurumEventFn emit;
+    void *user;
+
+    char line[AURUM_LINE_MAX];
+    uint16_t len;
+    uint16_t nfields;
+    uint16_t field_off[AURUM_FIELDS_MAX];
+    uint16_t field_len[AURUM_FIELDS_MAX];
+    uint8_t in_field;
+    uint8_t overflow;
+
+    // Counters for diagnostics
+    unsigned long lines;
+    unsigned long events;
+    unsigned long unknown;
+    unsigned long overflows;
+} AurumParser;
+
+void aurum_parser_init(AurumParser *p, unsigned dialects,
+                       AurumEventFn emit, void *user);
+
+// Drop any partially received line
+void aurum_parser_reset(AurumParser *p);
+
+// Consume a raw chunk from the UART; emits zero or more events
+void aurum_parser_feed(AurumParser *p, const char *data, size_t n);
+
+const char *aurum_control_name(AurumControl c);
+
+#endif
@@ -0,0 +1,102 @@
+// ==========================
+//  AURUM SERIAL EVENT QUEUE
+//  Bounded single-producer / single-consumer ring of parsed events.
+//  Producer: serial reader thread. Consumer: GTK main loop.
+// ==========================
+
+#ifndef AURUM_QUEUE_H
+#define AURUM_QUEUE_H
+
+#include "aurum_protocol.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+
+#define AURUM_QUEUE_CAPACITY 256   // must be a power of two
+
+typedef struct {
+    AurumEvent ev;
+    int64_t arrival_us;     // CLOCK_MONOTONIC when the line completed
+} AurumQueuedEvent;
+
+typedef struct {
+    // Producer and consumer indices live on separate cache lines
+    _Alignas(64) atomic_uint head;      // next slot to write (producer)
+    _Alignas(64) atomic_uint tail;      // next slot to read (consumer)
+    _Alignas(64) atomic_uint high_water;
+    atomic_ulong full_stalls;           // events that found the ring full
+    AurumQueuedEvent slots[AURUM_QUEUE_CAPACITY];
+} AurumQueue;
+
+static inline int64_t aurum_monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline void aurum_queue_init(AurumQueue *q)
+{
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->high_water, 0);
+    atomic_init(&q->full_stalls, 0);
+}
+
+static inline unsigned aurum_queue_depth(AurumQueue *q)
+{
+    unsigned head = atomic_load_explicit(&q->head, memory_order_acquire);
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return head - tail;
+}
+
+// Producer side. Returns 0 when the ring is full (event not queued); the
+// caller retries and counts the stall once with aurum_queue_note_full().
+static inline int aurum_queue_push(AurumQueue *q, const AurumEvent *ev,
+                                   int64_t arrival_us)
+{
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    unsigned depth = head - tail;
+
+    if (depth >= AURUM_QUEUE_CAPACITY)
+        return 0;
+
+    AurumQueuedEvent *slot = &q->slots[head & (AURUM_QUEUE_CAPACITY - 1)];
+    slot->ev = *ev;
+    slot->arrival_us = arrival_us;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+
+    if (depth + 1 > atomic_load_explicit(&q->high_water, memory_order_relaxed))
+        atomic_store_explicit(&q->high_water, depth + 1, memory_order_relaxed);
+    return 1;
+}
+
+// Producer side: one event had to wait for room, however many retries
+static inline void aurum_queue_note_full(AurumQueue *q)
+{
+    atomic_fetch_add_explicit(&q->full_stalls, 1, memory_order_relaxed);
+}
+
+// Consumer side. Returns 0 when the ring is empty.
+static inline int aurum_queue_pop(AurumQueue *q, AurumQueuedEvent *out)
+{
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+    if (head == tail)
+        return 0;
+
+    *out = q->slots[tail & (AURUM_QUEUE_CAPACITY - 1)];
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+// Read and reset the burst high-water mark (consumer side)
+static inline unsigned aurum_queue_take_high_water(AurumQueue *q)
+{
+    return atomic_exchange_explicit(&q->high_water, 0, memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,222 @@
+// ==========================
+//  AURUM SERIAL TRAFFIC RECORDING
+// ==========================
+
+#include "aurum_record.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HEADER_LEN (sizeof(AURUM_RECORD_MAGIC) - 1 + 1)
+
+// ===================== VARINTS =====================
+static size_t put_varint(uint8_t *out, uint64_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Returns 0 if the varint runs past end or is over-long
+static int get_varint(const uint8_t **p, const uint8_t *end, uint64_t *v)
+{
+    uint64_t x = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*p >= end)
+            return 0;
+        uint8_t b = *(*p)++;
+        x |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *v = x;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ===================== RECORDER =====================
+static void write_record(AurumRecorder *r, const uint8_t *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(r->fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            r->errors++;
+            return;
+        }
+        buf += n;
+        len -= (size_t)n;
+        r->bytes += (size_t)n;
+    }
+}
+
+int aurum_recorder_open(AurumRecorder *r, const char *path,
+                        int64_t now_us, int64_t wall_us)
+{
+    struct stat st;
+
+    memset(r, 0, sizeof(*r));
+    r->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (r->fd < 0)
+        return -1;
+
+    if (fstat(r->fd, &st) < 0)
+        goto fail;
+
+    if (st.st_size == 0) {
+        uint8_t hdr[HEADER_LEN];
+        memcpy(hdr, AURUM_RECORD_MAGIC, HEADER_LEN - 1);
+        hdr[HEADER_LEN - 1] = AURUM_RECORD_VERSION;
+        write_record(r, hdr, sizeof(hdr));
+    } else {
+        // Appending: never add sessions to something that is not ours
+        uint8_t hdr[HEADER_LEN];
+        if (pread(r->fd, hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) ||
+            memcmp(hdr, AURUM_RECORD_MAGIC, HEADER_LEN - 1) != 0 ||
+            hdr[HEADER_LEN - 1] != AURUM_RECORD_VERSION) {
+            errno = EINVAL;
+            goto fail;
+        }
+    }
+
+    uint8_t rec[1 + 10 + 8];
+    size_t n = put_varint(rec, 0);
+    n += put_varint(rec + n, (uint64_t)now_us);
+    for (int i = 0; i < 8; i++)
+        rec[n++] = (uint8_t)((uint64_t)wall_us >> (8 * i));
+    write_record(r, rec, n);
+
+    r->last_us = now_us;
+    return r->errors ? -1 : 0;
+
+fail: {
+        int err = errno;
+        close(r->fd);
+        r->fd = -1;
+        errno = err;
+        return -1;
+    }
+}
+
+static void flush_line(AurumRecorder *r, int64_t now_us)
+{
+    uint8_t rec[10 + 10 + AURUM_LINE_MAX];
+    int64_t delta = now_us - r->last_us;
+    size_t n;
+
+    if (delta < 0)
+        delta = 0;
+    n = put_varint(rec, r->len);
+    n += put_varint(rec + n, (uint64_t)delta);
+    memcpy(rec + n, r->line, r->len);
+    write_record(r, rec, n + r->len);
+
+    r->last_us = now_us;
+    r->len = 0;
+    r->lines++;
+}
+
+void aurum_recorder_feed(AurumRecorder *r, const char *data, size_t n, int64_t now_us)
+{
+    size_t i = 0;
+
+    if (r->fd < 0)
+        return;
+
+    if (r->cr_pending && n > 0) {
+        if (data[0] == '\n')
+            r->line[r->len++] = data[i++];
+        flush_line(r, r->cr_us);
+        r->cr_pending = 0;
+    }
+
+    for (; i < n; i++) {
+        char c = data[i];
+        r->line[r->len++] = c;
+        if (r->len == sizeof(r->line) || c == '\n') {
+            flush_line(r, now_us);
+        } else if (c == '\r') {
+            if (i + 1 == n) {
+                r->cr_pending = 1;
+                r->cr_us = now_us;
+                continue;
+            }
+            if (data[i + 1] == '\n')
+                r->line[r->len++] = data[++i];
+            flush_line(r, now_us);
+        }
+    }
+}
+
+void aurum_recorder_close(AurumRecorder *r)
+{
+    if (r->fd < 0)
+        return;
+    if (r->len > 0)             // partial last line, or one waiting for its '\n'
+        flush_line(r, r->cr_pending ? r->cr_us : r->last_us);
+    close(r->fd);
+    r->fd = -1;
+}
+
+// ===================== READER =====================
+int aurum_record_reader_init(AurumRecordReader *rd, const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+
+    if (len < HEADER_LEN || memcmp(p, AURUM_RECORD_MAGIC, HEADER_LEN - 1) != 0 ||
+        p[HEADER_LEN - 1] != AURUM_RECORD_VERSION)
+        return -1;
+
+    rd->p = p + HEADER_LEN;
+    rd->end = p + len;
+    rd->t_us = 0;
+    return 0;
+}
+
+AurumRecordType aurum_record_next(AurumRecordReader *rd, AurumRecord *rec)
+{
+    uint64_t len, t;
+
+    memset(rec, 0, sizeof(*rec));
+    if (rd->p >= rd->end)
+        return rec->type = AURUM_REC_END;
+
+    if (!get_varint(&rd->p, rd->end, &len) || !get_varint(&rd->p, rd->end, &t))
+        goto corrupt;
+
+    if (len == 0) {
+        if (rd->end - rd->p < 8)
+            goto corrupt;
+        uint64_t wall = 0;
+        for (int i = 0; i < 8; i++)
+            wall |= (uint64_t)rd->p[i] << (8 * i);
+        rd->p += 8;
+        rd->t_us = (int64_t)t;
+        rec->type = AURUM_REC_SESSION;
+        rec->t_us = rd->t_us;
+        rec->wall_us = (int64_t)wall;
+        return rec->type;
+    }
+
+    if (len > AURUM_LINE_MAX || (uint64_t)(rd->end - rd->p) < len)
+        goto corrupt;
+    rd->t_us += (int64_t)t;
+    rec->type = AURUM_REC_LINE;
+    rec->t_us = rd->t_us;
+    rec->data = (const char *)rd->p;
+    rec->len = (size_t)len;
+    rd->p += len;
+    return rec->type;
+
+corrupt:
+    rd->p = rd->end;
+    return rec->type = AURUM_REC_CORRUPT;
+}
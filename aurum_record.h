@@ -0,0 +1,83 @@
+// ==========================
+//  AURUM SERIAL TRAFFIC RECORDING
+//  Every received line with its monotonic arrival time, in a compact
+//  append-only file, and a reader for replaying it.
+//
+//  File:    "AURUMREC" <version byte> then records
+//  Record:  varint len, then
+//             len > 0   varint delta_us (since the previous record), len bytes
+//             len == 0  session start: varint monotonic_us, 8-byte LE wall-clock us
+//  Varints are unsigned LEB128. Each kiosk start appends a session record,
+//  so one file can hold several runs. A token line costs its text plus
+//  2..5 bytes.
+// ==========================
+
+#ifndef AURUM_RECORD_H
+#define AURUM_RECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aurum_protocol.h"
+
+#define AURUM_RECORD_MAGIC   "AURUMREC"
+#define AURUM_RECORD_VERSION 1
+
+// ===================== RECORDER =====================
+typedef struct {
+    int fd;
+    int64_t last_us;            // time of the previous record
+    char line[AURUM_LINE_MAX];  // bytes since the last line end
+    size_t len;
+    int cr_pending;             // line ended on a chunk's last '\r'; a '\n' may follow
+    int64_t cr_us;              // when that '\r' arrived
+
+    // Stats
+    unsigned long lines;
+    unsigned long bytes;        // written to the file
+    unsigned long errors;       // failed writes (the record is lost)
+} AurumRecorder;
+
+/*
+ * Open path for appending (header written if new) and start a session.
+ * Returns 0, or -1 with errno set; EINVAL if the file is not a recording.
+ */
+int aurum_recorder_open(AurumRecorder *r, const char *path,
+                        int64_t now_us, int64_t wall_us);
+
+// Bytes as read from the port; one record per completed line (or per
+// AURUM_LINE_MAX bytes without a line end), timed now_us. One write() each.
+// Lines end on '\r' or '\n' as aurum_parser splits them, "\r\n" staying
+// one record; a '\r' that ends a chunk waits for the next byte to see if
+// a '\n' follows, and is still timed when it arrived.
+void aurum_recorder_feed(AurumRecorder *r, const char *data, size_t n, int64_t now_us);
+
+void aurum_recorder_close(AurumRecorder *r);
+
+// ===================== READER =====================
+typedef enum {
+    AURUM_REC_LINE,
+    AURUM_REC_SESSION,
+    AURUM_REC_END,
+    AURUM_REC_CORRUPT,          // truncated or malformed; nothing after is read
+} AurumRecordType;
+
+typedef struct {
+    AurumRecordType type;
+    int64_t t_us;               // monotonic time (the session start for SESSION)
+    int64_t wall_us;            // SESSION only
+    const char *data;           // LINE only: points into the reader's buffer
+    size_t len;
+} AurumRecord;
+
+typedef struct {
+    const uint8_t *p, *end;
+    int64_t t_us;
+} AurumRecordReader;
+
+// Whole file in memory; returns -1 if buf does not start with the header
+int aurum_record_reader_init(AurumRecordReader *rd, const void *buf, size_t len);
+
+AurumRecordType aurum_record_next(AurumRecordReader *rd, AurumRecord *rec);
+
+#endif
@@ -0,0 +1,303 @@
+// ==========================
+//  SERIAL TRAFFIC REPLAY
+//
+//  gcc -O2 aurum_replay.c aurum_record.c -o aurum_replay
+//  ./aurum_replay [-s SPEED | -f] [-l LINK] [-n] FILE    replay through a pty
+//  ./aurum_replay -d FILE                                 print the recording
+//
+//  Plays a recording made with AURUM_RECORD=<path> back through a
+//  pseudo-terminal, with the original gaps between lines divided by
+//  SPEED (default 1), or with no gaps at all (-f). The pty's slave is
+//  symlinked at LINK (default /tmp/aurum-replay): run the kiosk with
+//  AURUM_SERIAL_PORT=/tmp/aurum-replay. Playback starts when the kiosk
+//  sends its first "snap" (-n: immediately). The gap between two recorded
+//  sessions is cut to SESSION_GAP_US. What the kiosk sends back is read
+//  and discarded so its heartbeats never block.
+// ==========================
+
+#define _GNU_SOURCE
+#include "aurum_record.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_LINK   "/tmp/aurum-replay"
+#define SESSION_GAP_US 2000000
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    char *buf = NULL;
+    long size;
+
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) >= 0 &&
+        fseek(f, 0, SEEK_SET) == 0 && (buf = malloc((size_t)size + 1)) != NULL &&
+        fread(buf, 1, (size_t)size, f) == (size_t)size) {
+        *len = (size_t)size;
+    } else {
+        perror(path);
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    return buf;
+}
+
+// ===================== DUMP =====================
+static void print_line(const char *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)data[i];
+        if (c == '\r')
+            fputs("\\r", stdout);
+        else if (c == '\n')
+            fputs("\\n", stdout);
+        else if (c < 0x20 || c >= 0x7f)
+            printf("\\x%02x", c);
+        else
+            putchar(c);
+    }
+    putchar('\n');
+}
+
+static int dump(AurumRecordReader *rd)
+{
+    AurumRecord rec;
+    int64_t session_us = 0;
+    unsigned long lines = 0;
+
+    while (aurum_record_next(rd, &rec) == AURUM_REC_LINE ||
+           rec.type == AURUM_REC_SESSION) {
+        if (rec.type == AURUM_REC_SESSION) {
+            time_t wall = (time_t)(rec.wall_us / 1000000);
+            char when[64];
+            strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&wall));
+            printf("-- session started %s\n", when);
+            session_us = rec.t_us;
+            continue;
+        }
+        printf("%12.3f  ", (rec.t_us - session_us) / 1e6);
+        print_line(rec.data, rec.len);
+        lines++;
+    }
+    printf("-- %lu lines%s\n", lines,
+           rec.type == AURUM_REC_CORRUPT ? ", file truncated or corrupt after this" : "");
+    return rec.type == AURUM_REC_CORRUPT;
+}
+
+// ===================== REPLAY =====================
+static int open_pty(const char *link)
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+
+    // Raw master side too, so "\r\n" is not rewritten by the line discipline
+    struct termios t;
+    tcgetattr(fd, &t);
+    cfmakeraw(&t);
+    tcsetattr(fd, TCSANOW, &t);
+
+    unlink(link);
+    if (symlink(ptsname(fd), link) < 0) {
+        perror(link);
+        close(fd);
+        return -1;
+    }
+    printf("serial stand-in: %s -> %s\n", link, ptsname(fd));
+    return fd;
+}
+
+// Read whatever the kiosk sent; returns bytes read (0 if none or not open)
+static size_t drain(int fd)
+{
+    char junk[256];
+    size_t total = 0;
+    ssize_t n;
+
+    while ((n = read(fd, junk, sizeof(junk))) > 0)
+        total += (size_t)n;
+    return total;
+}
+
+// Sleep until due_us while draining the pty; the last millisecond sleeps
+// on the clock alone so lines go out on time
+static void wait_until(int fd, int64_t due_us)
+{
+    for (;;) {
+        int64_t left = due_us - now_us();
+        if (left <= 1000)
+            break;
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, (int)((left - 1000) / 1000)) > 0) {
+            if (pfd.revents & POLLIN)
+                drain(fd);
+            else
+                usleep(1000);       // POLLHUP: the kiosk closed the port
+        }
+    }
+    struct timespec ts = { .tv_sec = due_us / 1000000, .tv_nsec = (due_us % 1000000) * 1000 };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+static void write_all(int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN) {
+                drain(fd);
+                usleep(1000);
+                continue;
+            }
+            perror("pty write");
+            return;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static int replay(AurumRecordReader *rd, int fd, double speed, int wait_first)
+{
+    AurumRecord rec;
+    int64_t last_t = -1;
+    int64_t offset_us = 0;          // recording time, gaps between sessions cut
+    int64_t start_us, max_late_us = 0, total_late_us = 0;
+    unsigned long lines = 0, bytes = 0;
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    if (wait_first) {
+        printf("waiting for the kiosk to open the port...\n");
+        for (;;) {
+            struct pollfd pfd = { .fd = fd, .events = POLLIN };
+            if (poll(&pfd, 1, 100) > 0 && (pfd.revents & POLLIN) && drain(fd) > 0)
+                break;
+            if (pfd.revents & POLLHUP)
+                usleep(100000);     // no slave yet
+        }
+    }
+
+    start_us = now_us();
+    while (aurum_record_next(rd, &rec) == AURUM_REC_LINE ||
+           rec.type == AURUM_REC_SESSION) {
+        if (rec.type == AURUM_REC_SESSION) {
+            if (last_t >= 0) {
+                int64_t gap = rec.t_us - last_t;
+                offset_us += (gap >= 0 && gap < SESSION_GAP_US) ? gap : SESSION_GAP_US;
+            }
+            last_t = rec.t_us;
+            continue;
+        }
+
+        offset_us += last_t >= 0 ? rec.t_us - last_t : 0;
+        last_t = rec.t_us;
+
+        if (speed > 0) {
+            int64_t due = start_us + (int64_t)(offset_us / speed);
+            wait_until(fd, due);
+            int64_t late = now_us() - due;
+            total_late_us += late;
+            if (late > max_late_us)
+                max_late_us = late;
+        }
+        write_all(fd, rec.data, rec.len);
+        lines++;
+        bytes += rec.len;
+    }
+    drain(fd);
+
+    double secs = (now_us() - start_us) / 1e6;
+    printf("replayed %lu lines (%lu bytes) in %.3f s, recorded span %.3f s\n",
+           lines, bytes, secs, offset_us / 1e6);
+    if (speed > 0 && lines > 0)
+        printf("timing: mean %.0f us late, max %.0f us late\n",
+               (double)total_late_us / lines, (double)max_late_us);
+    if (rec.type == AURUM_REC_CORRUPT)
+        fprintf(stderr, "recording truncated or corrupt; stopped there\n");
+    return rec.type == AURUM_REC_CORRUPT;
+}
+
+// ===================== MAIN =====================
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [-s SPEED | -f] [-l LINK] [-n] FILE\n"
+                    "       %s -d FILE\n", argv0, argv0);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *link = DEFAULT_LINK;
+    double speed = 1.0;
+    int dump_only = 0, wait_first = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:fl:nd")) != -1) {
+        switch (opt) {
+        case 's':
+            speed = atof(optarg);
+            if (speed <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        case 'f': speed = 0; break;
+        case 'l': link = optarg; break;
+        case 'n': wait_first = 0; break;
+        case 'd': dump_only = 1; break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    size_t len;
+    void *buf = read_file(argv[optind], &len);
+    AurumRecordReader rd;
+    if (!buf)
+        return 1;
+    if (aurum_record_reader_init(&rd, buf, len) < 0) {
+        fprintf(stderr, "%s: not an aurum serial recording\n", argv[optind]);
+        return 1;
+    }
+
+    if (dump_only)
+        return dump(&rd);
+
+    int fd = open_pty(link);
+    if (fd < 0)
+        return 1;
+    int rc = replay(&rd, fd, speed, wait_first);
+    unlink(link);
+    close(fd);
+    free(buf);
+    return rc;
+}
@@ -0,0 +1,253 @@
+// ==========================
+//  AURUM SERIAL PORT SETUP
+// ==========================
+
+#include "aurum_serial.h"
+#include "aurum_protocol.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===================== BAUD TABLE =====================
+static const struct {
+    int baud;
+    speed_t speed;
+} baud_table[] = {
+    { 9600,   B9600   },
+    { 19200,  B19200  },
+    { 38400,  B38400  },
+    { 57600,  B57600  },
+    { 115200, B115200 },
+    { 230400, B230400 },
+    { 460800, B460800 },
+    { 500000, B500000 },
+    { 576000, B576000 },
+    { 921600, B921600 },
+};
+
+// Most likely first: the high-baud firmware, then the legacy 9600 build
+static const int autobaud_default[] = {
+    115200, 230400, 460800, 921600, 57600, 38400, 19200, 9600,
+};
+
+static speed_t baud_to_speed(int baud)
+{
+    for (size_t i = 0; i < sizeof(baud_table) / sizeof(baud_table[0]); i++)
+        if (baud_table[i].baud == baud)
+            return baud_table[i].speed;
+    return 0;
+}
+
+int aurum_serial_baud_supported(int baud)
+{
+    return baud_to_speed(baud) != 0;
+}
+
+// ===================== CONFIG =====================
+void aurum_serial_config_defaults(AurumSerialConfig *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    snprintf(cfg->port, sizeof(cfg->port), "%s", AURUM_SERIAL_DEFAULT_PORT);
+    cfg->baud = AURUM_SERIAL_DEFAULT_BAUD;
+    cfg->data_bits = 8;
+    cfg->parity = 'N';
+    cfg->stop_bits = 1;
+}
+
+int aurum_serial_configure(AurumSerialConfig *cfg, const char *port,
+                           const char *baud, const char *framing)
+{
+    if (port && *port)
+        snprintf(cfg->port, sizeof(cfg->port), "%s", port);
+
+    if (baud && *baud) {
+        if (strcmp(baud, "auto") == 0) {
+            cfg->baud = AURUM_SERIAL_AUTO_BAUD;
+        } else {
+            char *end = NULL;
+            long b = strtol(baud, &end, 10);
+            if (*end != '\0' || !aurum_serial_baud_supported((int)b)) {
+                fprintf(stderr, "Unsupported serial baud '%s'\n", baud);
+                return -1;
+            }
+            cfg->baud = (int)b;
+        }
+    }
+
+    if (framing && *framing) {
+        if (strlen(framing) != 3 ||
+            framing[0] < '5' || framing[0] > '8' ||
+            !strchr("NEO", framing[1]) ||
+            (framing[2] != '1' && framing[2] != '2')) {
+            fprintf(stderr, "Unsupported serial framing '%s' (expected e.g. 8N1)\n",
+                    framing);
+            return -1;
+        }
+        cfg->data_bits = framing[0] - '0';
+        cfg->parity = framing[1];
+        cfg->stop_bits = framing[2] - '0';
+    }
+
+    return 0;
+}
+
+// ===================== OPEN / TERMIOS =====================
+int aurum_serial_set_baud(int fd, int baud)
+{
+    speed_t speed = baud_to_speed(baud);
+    struct termios options;
+
+    if (!speed || tcgetattr(fd, &options) < 0)
+        return -1;
+
+    cfsetispeed(&options, speed);
+    cfsetospeed(&options, speed);
+    return tcsetattr(fd, TCSANOW, &options);
+}
+
+int aurum_serial_open(const AurumSerialConfig *cfg)
+{
+    // O_NONBLOCK so open() never waits for carrier; cleared below
+    int fd = open(cfg->port, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        perror(cfg->port);
+        return -1;
+    }
+
+    struct termios options;
+    if (tcgetattr(fd, &options) < 0) {
+        perror("tcgetattr");
+        close(fd);
+        return -1;
+    }
+
+    int baud = cfg->baud == AURUM_SERIAL_AUTO_BAUD ? AURUM_SERIAL_DEFAULT_BAUD
+                                                   : cfg->baud;
+    cfsetispeed(&options, baud_to_speed(baud));
+    cfsetospeed(&options, baud_to_speed(baud));
+
+    static const tcflag_t csize[] = { CS5, CS6, CS7, CS8 };
+
+    options.c_cflag |= (CLOCAL | CREAD);
+    options.c_cflag &= ~CSIZE;
+    options.c_cflag |= csize[cfg->data_bits - 5];
+    options.c_cflag &= ~(PARENB | PARODD);
+    if (cfg->parity == 'E')
+        options.c_cflag |= PARENB;
+    else if (cfg->parity == 'O')
+        options.c_cflag |= PARENB | PARODD;
+    if (cfg->stop_bits == 2)
+        options.c_cflag |= CSTOPB;
+    else
+        options.c_cflag &= ~CSTOPB;
+    options.c_cflag &= ~CRTSCTS;
+
+    options.c_iflag = IGNPAR;
+    options.c_oflag = 0;
+    options.c_lflag = 0;
+
+    // Callers wait in poll(); read() returns whatever has arrived
+    options.c_cc[VMIN]  = 1;
+    options.c_cc[VTIME] = 0;
+
+    if (tcsetattr(fd, TCSANOW, &options) < 0) {
+        perror("tcsetattr");
+        close(fd);
+        return -1;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    tcflush(fd, TCIFLUSH);
+    return fd;
+}
+
+// ===================== AUTO-BAUD =====================
+static long elapsed_ms_since(const struct timespec *t0)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - t0->tv_sec) * 1000 + (now.tv_nsec - t0->tv_nsec) / 1000000;
+}
+
+static void count_probe_event(const AurumEvent *ev, void *user)
+{
+    (void)ev;
+    (*(unsigned long *)user)++;
+}
+
+/*
+ * Read the reply into reply[] until a line parses into an event.
+ * 1 = parsed, 0 = buffer full of lines that never parsed, -1 = timeout.
+ * Framing and parity errors are dropped silently under IGNPAR, so a
+ * printable line alone says nothing about the rate.
+ */
+static int probe_reply(int fd, int timeout_ms, unsigned dialects,
+                       char *reply, size_t cap, size_t *len)
+{
+    struct timespec t0;
+    unsigned long parsed = 0;
+    AurumParser check;
+
+    aurum_parser_init(&check, dialects, count_probe_event, &parsed);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    *len = 0;
+
+    while (*len < cap) {
+        long left = timeout_ms - elapsed_ms_since(&t0);
+        if (left <= 0)
+            return -1;
+
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        int r = poll(&pfd, 1, (int)left);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return -1;
+
+        // Never read more than fits: every byte read is handed back
+        ssize_t n = read(fd, reply + *len, cap - *len);
+        if (n <= 0)
+            continue;
+
+        aurum_parser_feed(&check, reply + *len, (size_t)n);
+        *len += (size_t)n;
+        if (parsed > 0)
+            return 1;
+    }
+    return 0;
+}
+
+int aurum_serial_autobaud(int fd, const int *candidates, size_t ncandidates,
+                          const char *probe, int timeout_ms, unsigned dialects,
+                          char *reply, size_t reply_cap, size_t *reply_len)
+{
+    if (!candidates) {
+        candidates = autobaud_default;
+        ncandidates = sizeof(autobaud_default) / sizeof(autobaud_default[0]);
+    }
+    *reply_len = 0;
+
+    for (size_t i = 0; i < ncandidates; i++) {
+        if (aurum_serial_set_baud(fd, candidates[i]) < 0)
+            continue;
+
+        tcflush(fd, TCIOFLUSH);
+        if (write(fd, probe, strlen(probe)) < 0)
+            return -1;
+        tcdrain(fd);
+
+        if (probe_reply(fd, timeout_ms, dialects, reply, reply_cap, reply_len) == 1)
+            return candidates[i];
+    }
+
+    *reply_len = 0;
+    aurum_serial_set_baud(fd, AURUM_SERIAL_DEFAULT_BAUD);
+    return -1;
+}
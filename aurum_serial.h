@@ -0,0 +1,61 @@
+// ==========================
+//  AURUM SERIAL PORT SETUP
+//  Port / baud / framing from aurum.txt, raw termios, auto-baud probe.
+// ==========================
+
+#ifndef AURUM_SERIAL_H
+#define AURUM_SERIAL_H
+
+#include <stddef.h>
+
+#define AURUM_SERIAL_DEFAULT_PORT "/dev/serial0"
+#define AURUM_SERIAL_DEFAULT_BAUD 9600
+#define AURUM_SERIAL_AUTO_BAUD    0
+
+typedef struct {
+    char port[128];
+    int baud;           // bits per second, or AURUM_SERIAL_AUTO_BAUD
+    int data_bits;      // 5..8
+    char parity;        // 'N', 'E' or 'O'
+    int stop_bits;      // 1 or 2
+} AurumSerialConfig;
+
+void aurum_serial_config_defaults(AurumSerialConfig *cfg);
+
+/*
+ * Apply config strings as read from aurum.txt; NULL keeps the default.
+ *   port     AURUM_SERIAL_PORT     e.g. "/dev/serial0"
+ *   baud     AURUM_SERIAL_BAUD     9600..921600, or "auto"
+ *   framing  AURUM_SERIAL_FRAMING  e.g. "8N1", "8E1", "7O2"
+ * Returns 0 on success, -1 (with a message on stderr) on a bad value.
+ */
+int aurum_serial_configure(AurumSerialConfig *cfg, const char *port,
+                           const char *baud, const char *framing);
+
+// Open and configure the port (raw, VMIN=1/VTIME=0). Returns fd or -1.
+// With AURUM_SERIAL_AUTO_BAUD the port is left at the default baud.
+int aurum_serial_open(const AurumSerialConfig *cfg);
+
+// Change the line speed of an open port. Returns 0 or -1.
+int aurum_serial_set_baud(int fd, int baud);
+
+// Nonzero when the baud rate has a termios speed constant
+int aurum_serial_baud_supported(int baud);
+
+/*
+ * Auto-baud: for each candidate rate, send probe and wait up to
+ * timeout_ms for a reply line that aurum_parser decodes into an event
+ * under dialects (AURUM_DIALECT_*). The kiosk probes with "snap\r\n",
+ * not the "hdmi" heartbeat: the $S snapshot a controller sends back
+ * parses in both dialects, the heartbeat reply in neither. A wrong rate yields garbage,
+ * or nothing at all once IGNPAR drops the bad frames, and neither parses.
+ * Every byte read at the winning rate, the reply line included, is left
+ * in reply[0..*reply_len) for the caller to feed to its own parser.
+ * candidates == NULL uses the built-in list (115200 first, 9600 last).
+ * Returns the detected baud (port left at that speed) or -1.
+ */
+int aurum_serial_autobaud(int fd, const int *candidates, size_t ncandidates,
+                          const char *probe, int timeout_ms, unsigned dialects,
+                          char *reply, size_t reply_cap, size_t *reply_len);
+
+#endif
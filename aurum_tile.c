@@ -0,0 +1,351 @@
+// ==========================
+//  AURUM TOKEN TILE RENDERER
+// ==========================
+
+#include "aurum_tile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+const AurumTileStyle aurum_tile_styles[AURUM_TILE_SLOTS] = {
+    [AURUM_TILE_CURRENT] = {
+        "Current Draw", "#FFDAB9", "#FF0000", "#333333",
+        0.65, 0.15, -0.08, 0.03, -0.05, 0.41,
+        "Liberation Sans Bold", "Liberation Sans" },
+    [AURUM_TILE_PREVIOUS] = {
+        "Previous Draw", "#FFDAB9", "#0000FF", "#555555",
+        0.50, 0.07, -0.04, 0.03, -0.06, 0.30,
+        "Liberation Sans Bold", "Liberation Sans" },
+    [AURUM_TILE_PRECEDING] = {
+        "Preceding Draw", "#FFDAB9", "#3E2723", "#4F4F4F",
+        0.65, 0.11, -0.08, -0.03, -0.05, 0.3,
+        "Liberation Sans Bold", "Liberation Sans" },
+};
+
+static const struct {
+    const char *name;
+    cairo_format_t format;
+} formats[] = {
+    { "argb32",    CAIRO_FORMAT_ARGB32 },
+    { "rgb24",     CAIRO_FORMAT_RGB24 },
+};
+
+int aurum_tile_parse_format(const char *name, cairo_format_t *format)
+{
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+        if (strcmp(name, formats[i].name) == 0) {
+            *format = formats[i].format;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char *aurum_tile_format_name(cairo_format_t format)
+{
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+        if (formats[i].format == format)
+            return formats[i].name;
+    return "?";
+}
+
+static void set_color(cairo_t *cr, const char *hex)
+{
+    unsigned r, g, b;
+    if (hex && sscanf(hex, "#%02x%02x%02x", &r, &g, &b) == 3)
+        cairo_set_source_rgb(cr, r / 255.0, g / 255.0, b / 255.0);
+}
+
+void aurum_tile_renderer_init(AurumTileRenderer *r)
+{
+    memset(r, 0, sizeof(*r));
+
+    // Private font map: pango font maps must not be shared across threads
+    r->font_map = pango_cairo_font_map_new();
+    r->context = pango_font_map_create_context(r->font_map);
+    r->layout = pango_layout_new(r->context);
+    r->format = CAIRO_FORMAT_ARGB32;
+
+    // Outlines are captured on a scratch context with default options
+    r->scratch = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+    r->scratch_cr = cairo_create(r->scratch);
+    pango_cairo_update_context(r->scratch_cr, r->context);
+}
+
+static void font_free(AurumTileFont *f)
+{
+    pango_font_description_free(f->desc);
+    if (f->font)
+        g_object_unref(f->font);
+}
+
+static void fonts_clear(AurumTileRenderer *r)
+{
+    for (int i = 0; i < r->nfonts; i++)
+        font_free(&r->fonts[i]);
+    r->nfonts = 0;
+}
+
+void aurum_tile_renderer_free(AurumTileRenderer *r)
+{
+    for (int i = 0; i < r->nglyph_sets; i++)
+        for (size_t k = 0; k < sizeof(AURUM_TILE_GLYPHS) - 1; k++)
+            cairo_path_destroy(r->glyph_sets[i].glyphs[k].path);
+    for (int i = 0; i < r->ntexts; i++)
+        cairo_path_destroy(r->texts[i].path);
+    cairo_destroy(r->scratch_cr);
+    cairo_surface_destroy(r->scratch);
+
+    fonts_clear(r);
+    g_object_unref(r->layout);
+    g_object_unref(r->context);
+    g_object_unref(r->font_map);
+}
+
+// ===================== FONT CACHE =====================
+const AurumTileFont *aurum_tile_font(AurumTileRenderer *r, const char *name, int size)
+{
+    for (int i = 0; i < r->nfonts; i++) {
+        AurumTileFont *f = &r->fonts[i];
+        if (f->size == size && (f->name == name || strcmp(f->name, name) == 0)) {
+            f->last_used = ++r->font_clock;
+            r->font_hits++;
+            return f;
+        }
+    }
+
+    // A handful of sizes per window size; when full, the least recently
+    // used one makes room, so the sizes in use survive a resize
+    AurumTileFont *f;
+    if (r->nfonts == AURUM_TILE_FONTS) {
+        f = &r->fonts[0];
+        for (int i = 1; i < r->nfonts; i++)
+            if (r->fonts[i].last_used < f->last_used)
+                f = &r->fonts[i];
+        font_free(f);
+    } else {
+        f = &r->fonts[r->nfonts++];
+    }
+
+    char fontdesc[128];
+    snprintf(fontdesc, sizeof(fontdesc), "%s %d", name, size);
+
+    f->name = name;
+    f->size = size;
+    f->desc = pango_font_description_from_string(fontdesc);
+    f->font = pango_font_map_load_font(r->font_map, r->context, f->desc);
+    f->last_used = ++r->font_clock;
+    r->font_misses++;
+    return f;
+}
+
+// ===================== GLYPH PATHS =====================
+// Outline of text at the reference size; logical width/height returned
+static cairo_path_t *capture_path(AurumTileRenderer *r, const char *font,
+                                  const char *text, double *width, double *height)
+{
+    PangoRectangle logical;
+
+    pango_layout_set_font_description(r->layout,
+                                      aurum_tile_font(r, font, AURUM_TILE_PATH_SIZE)->desc);
+    pango_layout_set_text(r->layout, text, -1);
+    pango_layout_get_extents(r->layout, NULL, &logical);
+
+    cairo_new_path(r->scratch_cr);
+    cairo_move_to(r->scratch_cr, 0, 0);
+    pango_cairo_layout_path(r->scratch_cr, r->layout);
+    cairo_path_t *path = cairo_copy_path(r->scratch_cr);
+    cairo_new_path(r->scratch_cr);
+
+    *width = (double)logical.width / PANGO_SCALE;
+    *height = (double)logical.height / PANGO_SCALE;
+    return path;
+}
+
+static const AurumGlyphSet *glyph_set(AurumTileRenderer *r, const char *font)
+{
+    for (int i = 0; i < r->nglyph_sets; i++)
+        if (r->glyph_sets[i].font == font || strcmp(r->glyph_sets[i].font, font) == 0)
+            return &r->glyph_sets[i];
+    if (r->nglyph_sets == AURUM_TILE_GLYPH_SETS)
+        return NULL;
+
+    AurumGlyphSet *g = &r->glyph_sets[r->nglyph_sets++];
+    g->font = font;
+    for (size_t k = 0; k < sizeof(AURUM_TILE_GLYPHS) - 1; k++) {
+        char text[2] = { AURUM_TILE_GLYPHS[k], 0 };
+        g->glyphs[k].path = capture_path(r, font, text, &g->glyphs[k].advance,
+                                         &g->height);
+    }
+    return g;
+}
+
+static const AurumTextPath *text_path(AurumTileRenderer *r, const char *font,
+                                      const char *text)
+{
+    for (int i = 0; i < r->ntexts; i++) {
+        AurumTextPath *t = &r->texts[i];
+        if ((t->font == font || strcmp(t->font, font) == 0) &&
+            (t->text == text || strcmp(t->text, text) == 0))
+            return t;
+    }
+    if (r->ntexts == AURUM_TILE_TEXT_PATHS)
+        return NULL;
+
+    // Style strings are static, so the pointers can be kept
+    AurumTextPath *t = &r->texts[r->ntexts++];
+    t->font = font;
+    t->text = text;
+    t->path = capture_path(r, font, text, &t->width, &t->height);
+    return t;
+}
+
+void aurum_tile_prepare(AurumTileRenderer *r, const AurumTileStyle *styles,
+                        int nstyles, int w, int h)
+{
+    for (int i = 0; i < nstyles; i++) {
+        const AurumTileStyle *st = &styles[i];
+        if (w <= 0 || h <= 0) {
+            aurum_tile_font(r, st->num_font, 12);
+            aurum_tile_font(r, st->lab_font, 12);
+        } else {
+            aurum_tile_font(r, st->num_font, (int)(h * st->number_size_frac));
+            aurum_tile_font(r, st->lab_font, (int)(h * st->label_size_frac));
+            glyph_set(r, st->num_font);
+            if (st->label)
+                text_path(r, st->lab_font, st->label);
+        }
+    }
+}
+
+// ===================== RENDERING =====================
+// Top-left that centres a tw x th box on (w/2 + w*x_frac, h/2 + h*y_frac)
+static void text_origin(int w, int h, double x_frac, double y_frac,
+                        int tw, int th, double *x, double *y)
+{
+    *x = (w / 2 + (int)(w * x_frac)) - tw / 2;
+    *y = (h / 2 + (int)(h * y_frac)) - th / 2;
+}
+
+// Shaped by pango: for text the glyph paths do not cover
+static void draw_text(AurumTileRenderer *r, cairo_t *cr, int w, int h,
+                      const char *font, int size,
+                      double x_frac, double y_frac, const char *text)
+{
+    int tw, th;
+    double x, y;
+
+    pango_cairo_update_context(cr, r->context);
+    pango_layout_context_changed(r->layout);
+    pango_layout_set_font_description(r->layout, aurum_tile_font(r, font, size)->desc);
+    pango_layout_set_text(r->layout, text, -1);
+    pango_layout_get_pixel_size(r->layout, &tw, &th);
+    text_origin(w, h, x_frac, y_frac, tw, th, &x, &y);
+    cairo_move_to(cr, x, y);
+    pango_cairo_show_layout(cr, r->layout);
+    r->pango_draws++;
+}
+
+// Glyph index of c in AURUM_TILE_GLYPHS, or -1
+static int glyph_index(char c)
+{
+    const char *p = c ? strchr(AURUM_TILE_GLYPHS, c) : NULL;
+    return p ? (int)(p - AURUM_TILE_GLYPHS) : -1;
+}
+
+// Compose text from cached digit outlines; 0 if it has other characters
+static int fill_number(AurumTileRenderer *r, cairo_t *cr, int w, int h,
+                       const char *font, int size,
+                       double x_frac, double y_frac, const char *text)
+{
+    const AurumGlyphSet *g = glyph_set(r, font);
+    double advance = 0;
+
+    if (!g || !*text)
+        return 0;
+    for (const char *c = text; *c; c++) {
+        int k = glyph_index(*c);
+        if (k < 0)
+            return 0;
+        advance += g->glyphs[k].advance;
+    }
+
+    double scale = (double)size / AURUM_TILE_PATH_SIZE;
+    double x, y;
+    text_origin(w, h, x_frac, y_frac, (int)(advance * scale + 0.5),
+                (int)(g->height * scale + 0.5), &x, &y);
+
+    cairo_save(cr);
+    cairo_translate(cr, x, y);
+    cairo_scale(cr, scale, scale);
+    cairo_new_path(cr);
+    for (const char *c = text; *c; c++) {
+        const AurumGlyphPath *gp = &g->glyphs[glyph_index(*c)];
+        cairo_append_path(cr, gp->path);
+        cairo_translate(cr, gp->advance, 0);
+    }
+    cairo_fill(cr);
+    cairo_restore(cr);
+    return 1;
+}
+
+static int fill_text(AurumTileRenderer *r, cairo_t *cr, int w, int h,
+                     const char *font, int size,
+                     double x_frac, double y_frac, const char *text)
+{
+    const AurumTextPath *t = text_path(r, font, text);
+    if (!t)
+        return 0;
+
+    double scale = (double)size / AURUM_TILE_PATH_SIZE;
+    double x, y;
+    text_origin(w, h, x_frac, y_frac, (int)(t->width * scale + 0.5),
+                (int)(t->height * scale + 0.5), &x, &y);
+
+    cairo_save(cr);
+    cairo_translate(cr, x, y);
+    cairo_scale(cr, scale, scale);
+    cairo_new_path(cr);
+    cairo_append_path(cr, t->path);
+    cairo_fill(cr);
+    cairo_restore(cr);
+    return 1;
+}
+
+cairo_surface_t *aurum_tile_render(AurumTileRenderer *r, int w, int h,
+                                   const char *number,
+                                   const AurumTileStyle *st, int show_number)
+{
+    cairo_surface_t *surface = cairo_image_surface_create(r->format, w, h);
+    cairo_t *cr = cairo_create(surface);
+
+    set_color(cr, st->bg_hex);
+    cairo_paint(cr);
+
+    // Outlines from the cache, scaled: no shaping on this path
+    if (show_number) {
+        const char *text = number ? number : "--";
+        int size = (int)(h * st->number_size_frac);
+
+        set_color(cr, st->num_hex);
+        if (!fill_number(r, cr, w, h, st->num_font, size,
+                         st->number_x_frac, st->number_y_frac, text))
+            draw_text(r, cr, w, h, st->num_font, size,
+                      st->number_x_frac, st->number_y_frac, text);
+    }
+
+    // Label is always shown
+    if (st->label && *st->label) {
+        int size = (int)(h * st->label_size_frac);
+
+        set_color(cr, st->lab_hex);
+        if (!fill_text(r, cr, w, h, st->lab_font, size,
+                       st->label_x_frac, st->label_y_frac, st->label))
+            draw_text(r, cr, w, h, st->lab_font, size,
+                      st->label_x_frac, st->label_y_frac, st->label);
+    }
+
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+    return surface;
+}
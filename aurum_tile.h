@@ -0,0 +1,125 @@
+// ==========================
+//  AURUM TOKEN TILE RENDERER
+//  Draws one token tile (number + slot label) into a cairo image surface.
+//  A renderer owns its PangoFontMap, context, layout and font cache and
+//  must only be used from one thread; it never touches GTK, so it can run
+//  on a worker.
+// ==========================
+
+#ifndef AURUM_TILE_H
+#define AURUM_TILE_H
+
+#include <cairo.h>
+#include <pango/pangocairo.h>
+
+// Per-slot look of a token tile (colours, layout fractions, fonts)
+typedef struct {
+    const char *label;
+    const char *bg_hex;
+    const char *num_hex;
+    const char *lab_hex;
+    double number_size_frac;
+    double label_size_frac;
+    double number_x_frac;
+    double number_y_frac;
+    double label_x_frac;
+    double label_y_frac;
+    const char *num_font;
+    const char *lab_font;
+} AurumTileStyle;
+
+// The kiosk's slots and their look
+enum { AURUM_TILE_CURRENT, AURUM_TILE_PREVIOUS, AURUM_TILE_PRECEDING, AURUM_TILE_SLOTS };
+extern const AurumTileStyle aurum_tile_styles[AURUM_TILE_SLOTS];
+
+#define AURUM_TILE_FONTS 32
+
+/*
+ * A resolved font: the style's font string ("Liberation Sans Bold") at a
+ * size, parsed and matched once. Sizes are in points as pango reads
+ * "Family N", which is how tile sizes have always been specified.
+ */
+typedef struct {
+    const char *name;
+    int size;
+    PangoFontDescription *desc;
+    PangoFont *font;
+    unsigned long last_used;    // renderer's font_clock at the last lookup
+} AurumTileFont;
+
+/*
+ * Text outlines captured once at AURUM_TILE_PATH_SIZE and replayed at any
+ * size with a scale: the digits and '-' of a number font, and whole
+ * strings for the fixed slot labels. Paths start at the layout's top-left.
+ */
+#define AURUM_TILE_PATH_SIZE 200
+#define AURUM_TILE_GLYPHS "0123456789-"
+#define AURUM_TILE_GLYPH_SETS 4
+#define AURUM_TILE_TEXT_PATHS 8
+
+typedef struct {
+    cairo_path_t *path;
+    double advance;
+} AurumGlyphPath;
+
+typedef struct {
+    const char *font;
+    double height;              // logical line height
+    AurumGlyphPath glyphs[sizeof(AURUM_TILE_GLYPHS) - 1];
+} AurumGlyphSet;
+
+typedef struct {
+    const char *font;
+    const char *text;
+    cairo_path_t *path;
+    double width, height;       // logical extents
+} AurumTextPath;
+
+typedef struct {
+    PangoFontMap *font_map;
+    PangoContext *context;
+    PangoLayout *layout;
+    cairo_format_t format;      // of rendered tiles; ARGB32 unless set
+
+    AurumTileFont fonts[AURUM_TILE_FONTS];
+    int nfonts;
+    unsigned long font_clock;
+    unsigned long font_hits;
+    unsigned long font_misses;
+
+    // Outline capture
+    cairo_surface_t *scratch;
+    cairo_t *scratch_cr;
+    AurumGlyphSet glyph_sets[AURUM_TILE_GLYPH_SETS];
+    int nglyph_sets;
+    AurumTextPath texts[AURUM_TILE_TEXT_PATHS];
+    int ntexts;
+    unsigned long pango_draws;  // text that had to go through pango
+} AurumTileRenderer;
+
+void aurum_tile_renderer_init(AurumTileRenderer *r);
+void aurum_tile_renderer_free(AurumTileRenderer *r);
+
+// Cached font for (name, size); resolved on first use
+const AurumTileFont *aurum_tile_font(AurumTileRenderer *r, const char *name, int size);
+
+// Resolve every style's fonts at the sizes a w x h tile uses and capture
+// their outlines. With w or h 0 only the families are matched, which is
+// what pays fontconfig's start-up scan.
+void aurum_tile_prepare(AurumTileRenderer *r, const AurumTileStyle *styles,
+                        int nstyles, int w, int h);
+
+// Tiles are opaque, so RGB24 renders the same picture as ARGB32 without
+// the alpha channel for the compositor to blend. There is no 16-bit
+// format: RGB16_565 shifts the #FFDAB9 background the window paints
+// directly, leaving seams at tile edges.
+// "argb32" | "rgb24" -> format; returns 0 if unknown
+int aurum_tile_parse_format(const char *name, cairo_format_t *format);
+const char *aurum_tile_format_name(cairo_format_t format);
+
+// New w x h surface in r->format; number NULL = "--", label only if !show_number
+cairo_surface_t *aurum_tile_render(AurumTileRenderer *r, int w, int h,
+                                   const char *number,
+                                   const AurumTileStyle *st, int show_number);
+
+#endif
@@ -0,0 +1,262 @@
+// ==========================
+//  AURUM VT SWITCH MANAGER
+// ==========================
+
+#include "aurum_vt.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/vt.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char **environ;
+
+static int64_t vt_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===================== REAL CONSOLE OPS =====================
+static int linux_open(void *ctx, const char *path)
+{
+    (void)ctx;
+    int fd = open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0)
+        fd = open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC);
+    return fd;
+}
+
+static int linux_ioctl(void *ctx, int fd, unsigned long request, unsigned long arg)
+{
+    (void)ctx;
+    return ioctl(fd, request, arg);
+}
+
+static void linux_close(void *ctx, int fd)
+{
+    (void)ctx;
+    close(fd);
+}
+
+const AurumVtOps aurum_vt_linux_ops = {
+    linux_open, linux_ioctl, linux_close, NULL,
+};
+
+// ===================== SWITCHING =====================
+/*
+ * Sleep before the next check: 1 ms first, since a free console switches
+ * within a frame or two, then doubling so a stuck switch costs a few
+ * dozen wakeups over the deadline rather than one per millisecond.
+ */
+static void poll_wait(int64_t *delay_us, int64_t deadline)
+{
+    int64_t left = deadline - vt_now_us();
+    if (left <= 0)
+        return;
+    usleep((useconds_t)(*delay_us < left ? *delay_us : left));
+    if (*delay_us < AURUM_VT_POLL_MAX_US)
+        *delay_us *= 2;
+    if (*delay_us > AURUM_VT_POLL_MAX_US)
+        *delay_us = AURUM_VT_POLL_MAX_US;
+}
+
+static AurumVtResult run_fallback(AurumVt *vt, int n)
+{
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), vt->fallback_cmd, n);
+
+    char *argv[] = { "/bin/sh", "-c", cmd, NULL };
+    pid_t pid;
+    int status;
+
+    if (posix_spawn(&pid, "/bin/sh", NULL, NULL, argv, environ) != 0)
+        return AURUM_VT_FAILED;
+
+    // chvt waits for the switch itself: don't let it hang the worker
+    int64_t deadline = vt_now_us() + vt->switch_timeout_us;
+    int64_t delay = AURUM_VT_POLL_MIN_US;
+    pid_t r;
+    while ((r = waitpid(pid, &status, WNOHANG)) == 0 && vt_now_us() < deadline)
+        poll_wait(&delay, deadline);
+    if (r == 0) {
+        fprintf(stderr, "'%s' still running after %lld ms, stopping it\n",
+                cmd, (long long)(vt->switch_timeout_us / 1000));
+        kill(pid, SIGTERM);
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+            ;
+        return AURUM_VT_FAILED;
+    }
+    if (r < 0)
+        return AURUM_VT_FAILED;
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? AURUM_VT_FALLBACK
+                                                           : AURUM_VT_FAILED;
+}
+
+static int active_vt(AurumVt *vt)
+{
+    struct vt_stat st;
+    if (vt->ops.ioctl(vt->ops.ctx, vt->fd, VT_GETSTATE, (unsigned long)&st) < 0)
+        return -1;
+    return st.v_active;
+}
+
+static AurumVtResult switch_now(AurumVt *vt, int n)
+{
+    if (vt->fd < 0)
+        return run_fallback(vt, n);
+
+    int64_t deadline = vt_now_us() + vt->switch_timeout_us;
+
+    if (vt->ops.ioctl(vt->ops.ctx, vt->fd, VT_ACTIVATE, (unsigned long)n) < 0) {
+        if (errno == EPERM || errno == EACCES) {
+            // No CAP_SYS_TTY_CONFIG and not our console: use chvt from now on
+            fprintf(stderr, "VT_ACTIVATE not permitted, falling back to '%s'\n",
+                    vt->fallback_cmd);
+            pthread_mutex_lock(&vt->lock);
+            vt->ops.close(vt->ops.ctx, vt->fd);
+            vt->fd = -1;
+            pthread_mutex_unlock(&vt->lock);
+            return run_fallback(vt, n);
+        }
+        perror("VT_ACTIVATE");
+        return AURUM_VT_FAILED;
+    }
+
+    // VT_WAITACTIVE has no timeout and blocks forever if a VT_PROCESS
+    // owner never releases the console, so poll the state instead
+    int64_t delay = AURUM_VT_POLL_MIN_US;
+    for (;;) {
+        int active = active_vt(vt);
+        if (active == n)
+            return AURUM_VT_OK;
+        if (active < 0) {
+            perror("VT_GETSTATE");
+            return AURUM_VT_FAILED;
+        }
+        if (vt_now_us() >= deadline)
+            break;
+        poll_wait(&delay, deadline);
+    }
+
+    fprintf(stderr, "VT %d not active after %lld ms, trying '%s'\n", n,
+            (long long)(vt->switch_timeout_us / 1000), vt->fallback_cmd);
+    pthread_mutex_lock(&vt->lock);
+    vt->timeouts++;
+    pthread_mutex_unlock(&vt->lock);
+    return run_fallback(vt, n);
+}
+
+static void *vt_worker(void *arg)
+{
+    AurumVt *vt = arg;
+
+    pthread_mutex_lock(&vt->lock);
+    for (;;) {
+        while (vt->running && vt->pending_vt == 0)
+            pthread_cond_wait(&vt->wake, &vt->lock);
+        if (vt->pending_vt == 0)
+            break;   // shut down with nothing left to do
+
+        int n = vt->pending_vt;
+        int64_t queued_us = vt_now_us() - vt->pending_since_us;
+        vt->pending_vt = 0;
+        pthread_mutex_unlock(&vt->lock);
+
+        int64_t t0 = vt_now_us();
+        AurumVtResult r = switch_now(vt, n);
+        int64_t switch_us = vt_now_us() - t0;
+
+        pthread_mutex_lock(&vt->lock);
+        vt->switches++;
+        if (r == AURUM_VT_FALLBACK) vt->fallbacks++;
+        if (r == AURUM_VT_FAILED)   vt->failures++;
+        if (switch_us > vt->max_switch_us) vt->max_switch_us = switch_us;
+        pthread_mutex_unlock(&vt->lock);
+
+        if (vt->done)
+            vt->done(n, r, queued_us, switch_us, vt->user);
+
+        pthread_mutex_lock(&vt->lock);
+    }
+    pthread_mutex_unlock(&vt->lock);
+    return NULL;
+}
+
+// ===================== PUBLIC API =====================
+int aurum_vt_init(AurumVt *vt, const char *console, const AurumVtOps *ops,
+                  AurumVtDoneFn done, void *user)
+{
+    memset(vt, 0, sizeof(*vt));
+    vt->ops = ops ? *ops : aurum_vt_linux_ops;
+    vt->fallback_cmd = AURUM_VT_FALLBACK_CMD;
+    vt->switch_timeout_us = AURUM_VT_SWITCH_TIMEOUT_US;
+    vt->done = done;
+    vt->user = user;
+    vt->running = 1;
+
+    if (!console)
+        console = AURUM_VT_CONSOLE;
+    vt->fd = vt->ops.open(vt->ops.ctx, console);
+    if (vt->fd < 0)
+        fprintf(stderr, "Cannot open %s (%s), VT switches will use '%s'\n",
+                console, strerror(errno), vt->fallback_cmd);
+
+    pthread_mutex_init(&vt->lock, NULL);
+    pthread_cond_init(&vt->wake, NULL);
+    if (pthread_create(&vt->thread, NULL, vt_worker, vt) != 0) {
+        if (vt->fd >= 0)
+            vt->ops.close(vt->ops.ctx, vt->fd);
+        vt->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void aurum_vt_switch(AurumVt *vt, int n)
+{
+    pthread_mutex_lock(&vt->lock);
+    if (vt->pending_vt != 0)
+        vt->coalesced++;
+    else
+        vt->pending_since_us = vt_now_us();
+    vt->pending_vt = n;
+    pthread_cond_signal(&vt->wake);
+    pthread_mutex_unlock(&vt->lock);
+}
+
+int aurum_vt_active(AurumVt *vt)
+{
+    struct vt_stat st;
+    int active = -1;
+
+    pthread_mutex_lock(&vt->lock);
+    if (vt->fd >= 0 &&
+        vt->ops.ioctl(vt->ops.ctx, vt->fd, VT_GETSTATE, (unsigned long)&st) == 0)
+        active = st.v_active;
+    pthread_mutex_unlock(&vt->lock);
+    return active;
+}
+
+void aurum_vt_shutdown(AurumVt *vt)
+{
+    pthread_mutex_lock(&vt->lock);
+    vt->running = 0;
+    pthread_cond_signal(&vt->wake);
+    pthread_mutex_unlock(&vt->lock);
+    pthread_join(vt->thread, NULL);
+
+    if (vt->fd >= 0)
+        vt->ops.close(vt->ops.ctx, vt->fd);
+    vt->fd = -1;
+    pthread_mutex_destroy(&vt->lock);
+    pthread_cond_destroy(&vt->wake);
+}
@@ -0,0 +1,88 @@
+// ==========================
+//  AURUM VT SWITCH MANAGER
+//  Opens the console once and switches with VT_ACTIVATE, confirmed by
+//  polling VT_GETSTATE up to a deadline, on a worker thread, so callers
+//  (GTK main loop) never block or fork.
+//  Console access goes through AurumVtOps so a fake device can stand in.
+// ==========================
+
+#ifndef AURUM_VT_H
+#define AURUM_VT_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#define AURUM_VT_CONSOLE      "/dev/tty0"
+#define AURUM_VT_FALLBACK_CMD "sudo chvt %d"
+#define AURUM_VT_SWITCH_TIMEOUT_US 1000000   // VT_ACTIVATE -> active, then chvt
+#define AURUM_VT_POLL_MIN_US       1000      // first VT_GETSTATE re-check,
+#define AURUM_VT_POLL_MAX_US       20000     // doubling up to this meanwhile
+
+typedef enum {
+    AURUM_VT_OK,            // VT_GETSTATE confirmed the switch
+    AURUM_VT_FALLBACK,      // console unusable or switch timed out, ran chvt
+    AURUM_VT_FAILED,
+} AurumVtResult;
+
+// Console device access; ctx is passed through untouched
+typedef struct {
+    int  (*open)(void *ctx, const char *path);
+    int  (*ioctl)(void *ctx, int fd, unsigned long request, unsigned long arg);
+    void (*close)(void *ctx, int fd);
+    void *ctx;
+} AurumVtOps;
+
+extern const AurumVtOps aurum_vt_linux_ops;
+
+/*
+ * Called on the worker thread after each switch.
+ *   queued_us   request -> worker picked it up
+ *   switch_us   VT_ACTIVATE -> VT_GETSTATE showed n (or chvt exited)
+ */
+typedef void (*AurumVtDoneFn)(int vt, AurumVtResult result,
+                              int64_t queued_us, int64_t switch_us, void *user);
+
+typedef struct {
+    AurumVtOps ops;
+    int fd;                     // console fd, -1 when falling back to chvt
+    const char *fallback_cmd;   // printf format taking the VT number
+    int64_t switch_timeout_us;  // per switch, and again for the fallback
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int pending_vt;             // 0 = nothing pending; newer requests replace it
+    int64_t pending_since_us;
+    int running;
+
+    AurumVtDoneFn done;
+    void *user;
+
+    // Stats (worker thread writes, read under lock)
+    unsigned long switches;
+    unsigned long coalesced;    // requests replaced before they ran
+    unsigned long fallbacks;
+    unsigned long failures;
+    unsigned long timeouts;     // VT_ACTIVATE never took effect in time
+    int64_t max_switch_us;
+} AurumVt;
+
+/*
+ * Open console (NULL = AURUM_VT_CONSOLE) with ops (NULL = real ioctls) and
+ * start the worker. If the console cannot be opened every switch runs
+ * fallback_cmd instead. Returns 0, or -1 if the thread could not start.
+ */
+int aurum_vt_init(AurumVt *vt, const char *console, const AurumVtOps *ops,
+                  AurumVtDoneFn done, void *user);
+
+// Queue a switch to VT n and return immediately. Only the latest request
+// matters: one that has not started yet is replaced.
+void aurum_vt_switch(AurumVt *vt, int n);
+
+// Currently active VT from VT_GETSTATE, or -1
+int aurum_vt_active(AurumVt *vt);
+
+// Finish the pending switch, stop the worker and close the console
+void aurum_vt_shutdown(AurumVt *vt);
+
+#endif
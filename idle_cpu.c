@@ -0,0 +1,167 @@
+// ==========================
+//  IDLE CPU AND WAKEUP SAMPLER
+//
+//  gcc -O2 idle_cpu.c -o idle_cpu
+//  ./idle_cpu PID [SECONDS]      (default 10)
+//
+//  Samples a running process from /proc over a window and prints its CPU
+//  use and how often each of its threads woke up (voluntary plus
+//  involuntary context switches). Run it against the kiosk while it sits
+//  on one screen (token screen, or an overlay looping) to compare builds:
+//    ./idle_cpu $(pidof token_display) 30
+//  Needs no GTK, and works on any kiosk build, old or new.
+// ==========================
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS 64
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===================== /proc SAMPLING =====================
+typedef struct {
+    int tid;
+    char name[32];
+    unsigned long long ticks;       // utime + stime
+    unsigned long switches;         // voluntary + nonvoluntary
+} ThreadSample;
+
+typedef struct {
+    int64_t at_us;
+    int nthreads;
+    ThreadSample thread[MAX_THREADS];
+} Sample;
+
+static int read_file(const char *path, char *buf, size_t cap)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+    size_t n = fread(buf, 1, cap - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    return 0;
+}
+
+// One thread's CPU ticks, context switches and name; -1 if it has gone
+static int sample_thread(int pid, int tid, ThreadSample *t)
+{
+    char path[64], buf[4096];
+    unsigned long long utime, stime;
+
+    snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", pid, tid);
+    if (read_file(path, buf, sizeof(buf)) < 0)
+        return -1;
+
+    // comm may hold spaces and parentheses: fields restart after the last ')'
+    char *open = strchr(buf, '('), *close = strrchr(buf, ')');
+    if (!open || !close || close < open ||
+        sscanf(close + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+               &utime, &stime) != 2)
+        return -1;
+
+    size_t len = (size_t)(close - open - 1);
+    if (len >= sizeof(t->name))
+        len = sizeof(t->name) - 1;
+    memcpy(t->name, open + 1, len);
+    t->name[len] = '\0';
+    t->tid = tid;
+    t->ticks = utime + stime;
+    t->switches = 0;
+
+    snprintf(path, sizeof(path), "/proc/%d/task/%d/status", pid, tid);
+    if (read_file(path, buf, sizeof(buf)) < 0)
+        return -1;
+    for (char *line = buf; line; line = strchr(line, '\n')) {
+        unsigned long n;
+        if (*line == '\n')
+            line++;
+        if (sscanf(line, "voluntary_ctxt_switches: %lu", &n) == 1 ||
+            sscanf(line, "nonvoluntary_ctxt_switches: %lu", &n) == 1)
+            t->switches += n;
+    }
+    return 0;
+}
+
+static int sample(int pid, Sample *s)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR *d = opendir(path);
+    struct dirent *e;
+
+    if (!d)
+        return -1;
+    s->nthreads = 0;
+    s->at_us = now_us();
+    while ((e = readdir(d)) != NULL && s->nthreads < MAX_THREADS) {
+        int tid = atoi(e->d_name);
+        if (tid > 0 && sample_thread(pid, tid, &s->thread[s->nthreads]) == 0)
+            s->nthreads++;
+    }
+    closedir(d);
+    return s->nthreads > 0 ? 0 : -1;
+}
+
+static const ThreadSample *find_thread(const Sample *s, int tid)
+{
+    for (int i = 0; i < s->nthreads; i++)
+        if (s->thread[i].tid == tid)
+            return &s->thread[i];
+    return NULL;
+}
+
+// ===================== MAIN =====================
+int main(int argc, char *argv[])
+{
+    int pid = argc >= 2 ? atoi(argv[1]) : 0;
+    double seconds = argc >= 3 ? atof(argv[2]) : 10;
+    static Sample a, b;
+
+    if (argc < 2 || argc > 3 || pid <= 0 || seconds <= 0) {
+        fprintf(stderr, "usage: %s PID [SECONDS]\n", argv[0]);
+        return 2;
+    }
+    if (sample(pid, &a) < 0) {
+        fprintf(stderr, "cannot read /proc/%d\n", pid);
+        return 1;
+    }
+    usleep((useconds_t)(seconds * 1e6));
+    if (sample(pid, &b) < 0) {
+        fprintf(stderr, "process %d exited during the window\n", pid);
+        return 1;
+    }
+
+    double wall = (b.at_us - a.at_us) / 1e6;
+    double hz = (double)sysconf(_SC_CLK_TCK);
+    unsigned long long ticks = 0;
+    unsigned long switches = 0;
+
+    printf("pid %d over %.1f s\n\n", pid, wall);
+    printf("%8s %-16s %8s %12s\n", "tid", "thread", "CPU %", "wakeups/s");
+    for (int i = 0; i < b.nthreads; i++) {
+        const ThreadSample *t1 = &b.thread[i];
+        const ThreadSample *t0 = find_thread(&a, t1->tid);
+        unsigned long long dt = t1->ticks - (t0 ? t0->ticks : 0);
+        unsigned long ds = t1->switches - (t0 ? t0->switches : 0);
+        ticks += dt;
+        switches += ds;
+        printf("%8d %-16s %8.2f %12.1f%s\n", t1->tid, t1->name,
+               dt / hz / wall * 100, ds / wall, t0 ? "" : "  (new)");
+    }
+    printf("%8s %-16s %8.2f %12.1f\n", "", "total", ticks / hz / wall * 100,
+           switches / wall);
+    return 0;
+}
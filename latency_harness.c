@@ -0,0 +1,429 @@
+// ==========================
+//  END-TO-END TOKEN LATENCY HARNESS
+//
+//  gcc -O2 latency_harness.c -o latency_harness
+//  xvfb-run -s "-screen 0 1920x1080x24" ./latency_harness ./token_display [SINGLES [BURSTS [OVERLAYS]]]
+//
+//  Runs the kiosk with a pseudo-terminal as its serial port and measures
+//  the time from writing a line to the controller side of the pty to the
+//  frame that first shows the result, as reported by the kiosk's
+//  AURUM_LATENCY_TRACE (written on the frame clock's after-paint). Run it
+//  from the repo directory: the kiosk loads its .glade, style.css and
+//  the overlay GIFs from there. Scenarios (defaults 40, 5, 10):
+//    single    one ":01 1 N" line, spaced past the bulk threshold
+//    burst     five lines 20 ms apart; time from the last line to the
+//              last number shown (includes the kiosk's bulk-finish delay)
+//    overlay   ":00 3 7A" to congratulations on screen, ":00 3 7B" back
+//              to the token screen, and ":00 3 6A" to game over
+//  Each prints a latency histogram and percentiles.
+// ==========================
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BULK_GAP_US      600000     // past the kiosk's 500 ms bulk threshold
+#define BURST_TOKENS     5
+#define BURST_SPACING_US 20000
+#define START_TIMEOUT_US 30000000
+#define PAINT_TIMEOUT_US 10000000
+#define MAX_SAMPLES      1024
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===================== KIOSK PROCESS =====================
+typedef struct {
+    pid_t pid;
+    int master;                 // controller side of the serial pty
+    int trace;                  // read end of the kiosk's latency trace
+    char config[64];
+    char buf[4096];             // partial trace line
+    size_t len;
+} Kiosk;
+
+static int open_master(char *slave, size_t cap)
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+
+    // Raw master side too, so "\r\n" is not rewritten by the line discipline
+    struct termios t;
+    tcgetattr(fd, &t);
+    cfmakeraw(&t);
+    tcsetattr(fd, TCSANOW, &t);
+
+    snprintf(slave, cap, "%s", ptsname(fd));
+    return fd;
+}
+
+static int kiosk_start(Kiosk *k, const char *binary)
+{
+    char slave[64], cwd[PATH_MAX];
+    int tp[2];
+
+    memset(k, 0, sizeof(*k));
+    k->master = open_master(slave, sizeof(slave));
+    if (k->master < 0 || !getcwd(cwd, sizeof(cwd)))
+        return -1;
+
+    // The write end stays open across exec; the kiosk opens /dev/fd/N
+    if (pipe(tp) < 0) {
+        perror("pipe");
+        return -1;
+    }
+    fcntl(tp[0], F_SETFD, FD_CLOEXEC);
+    k->trace = tp[0];
+
+    snprintf(k->config, sizeof(k->config), "/tmp/aurum_latency_XXXXXX");
+    int cfd = mkstemp(k->config);
+    FILE *f = cfd >= 0 ? fdopen(cfd, "w") : NULL;
+    if (!f) {
+        perror("config");
+        return -1;
+    }
+    fprintf(f, "AURUM_SERIAL_PORT=%s\n", slave);
+    fprintf(f, "AURUM_SERIAL_BAUD=115200\n");
+    fprintf(f, "AURUM_OVERLAY_BACKEND=inprocess\n");
+    fprintf(f, "AURUM_OVERLAY_DIR=%s/\n", cwd);
+    fprintf(f, "AURUM_LATENCY_TRACE=/dev/fd/%d\n", tp[1]);
+    fclose(f);
+
+    k->pid = fork();
+    if (k->pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (k->pid == 0) {
+        setenv("AURUM_CONFIG", k->config, 1);
+        execl(binary, binary, (char *)NULL);
+        perror(binary);
+        _exit(127);
+    }
+    close(tp[1]);
+    return 0;
+}
+
+static void kiosk_stop(Kiosk *k)
+{
+    if (k->pid > 0) {
+        kill(k->pid, SIGTERM);
+        waitpid(k->pid, NULL, 0);
+    }
+    unlink(k->config);
+    close(k->master);
+    close(k->trace);
+}
+
+static void send_line(Kiosk *k, const char *line)
+{
+    size_t len = strlen(line);
+    while (len > 0) {
+        ssize_t n = write(k->master, line, len);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            perror("pty write");
+            return;
+        }
+        line += n;
+        len -= (size_t)n;
+    }
+}
+
+/*
+ * Read trace lines until one shows the wanted state (token NULL = any
+ * token; overlay NULL = any overlay) or the deadline passes. The kiosk's
+ * "hdmi" heartbeats are drained from the pty meanwhile so its writes
+ * never block. Returns the paint time, 0 on timeout, -1 if the kiosk died.
+ */
+static int64_t wait_paint(Kiosk *k, const char *token, const char *overlay,
+                          int64_t deadline_us)
+{
+    for (;;) {
+        char *nl;
+        while ((nl = memchr(k->buf, '\n', k->len)) != NULL) {
+            long long at;
+            char tok[32], ov[32];
+            *nl = '\0';
+            int ok = sscanf(k->buf, "%lld %31s %31s", &at, tok, ov) == 3 &&
+                     (!token || strcmp(tok, token) == 0) &&
+                     (!overlay || strcmp(ov, overlay) == 0);
+            size_t used = (size_t)(nl + 1 - k->buf);
+            memmove(k->buf, nl + 1, k->len - used);
+            k->len -= used;
+            if (ok)
+                return at;
+        }
+
+        int64_t left = deadline_us - now_us();
+        if (left <= 0)
+            return 0;
+
+        struct pollfd pfd[2] = {
+            { .fd = k->trace, .events = POLLIN },
+            { .fd = k->master, .events = POLLIN },
+        };
+        if (poll(pfd, 2, (int)(left / 1000) + 1) < 0 && errno != EINTR)
+            return -1;
+
+        if (pfd[1].revents & POLLIN) {
+            char junk[256];
+            if (read(k->master, junk, sizeof(junk)) < 0 && errno != EIO && errno != EAGAIN)
+                return -1;
+        }
+        if (pfd[0].revents & (POLLIN | POLLHUP)) {
+            if (k->len == sizeof(k->buf))
+                k->len = 0;
+            ssize_t n = read(k->trace, k->buf + k->len, sizeof(k->buf) - k->len);
+            if (n == 0) {
+                fprintf(stderr, "kiosk exited\n");
+                return -1;
+            }
+            if (n > 0)
+                k->len += (size_t)n;
+        }
+    }
+}
+
+// Sleep while keeping the trace and pty drained; no painted token is ""
+static int settle(Kiosk *k, int64_t us)
+{
+    return wait_paint(k, "", NULL, now_us() + us) < 0 ? -1 : 0;
+}
+
+// ===================== STATISTICS =====================
+typedef struct {
+    const char *name;
+    int64_t us[MAX_SAMPLES];
+    int n;
+    int timeouts;
+} Series;
+
+static void series_add(Series *s, int64_t sent_us, int64_t paint_us)
+{
+    if (paint_us <= 0)
+        s->timeouts++;
+    else if (s->n < MAX_SAMPLES)
+        s->us[s->n++] = paint_us - sent_us;
+}
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double pct_ms(const int64_t *sorted, int n, double p)
+{
+    int k = (int)(p / 100.0 * n + 0.5);
+    if (k < 1) k = 1;
+    if (k > n) k = n;
+    return sorted[k - 1] / 1000.0;
+}
+
+static void series_report(Series *s)
+{
+    static const int edges_ms[] = { 8, 17, 33, 50, 67, 100, 250, 500, 1000, 5000 };
+    const int nedges = sizeof(edges_ms) / sizeof(edges_ms[0]);
+    int counts[sizeof(edges_ms) / sizeof(edges_ms[0]) + 1] = { 0 };
+
+    printf("\n%s: %d samples, %d timeouts\n", s->name, s->n, s->timeouts);
+    if (s->n == 0)
+        return;
+
+    qsort(s->us, (size_t)s->n, sizeof(int64_t), cmp_i64);
+    printf("  p50 %.1f ms  p90 %.1f ms  p99 %.1f ms  min %.1f ms  max %.1f ms\n",
+           pct_ms(s->us, s->n, 50), pct_ms(s->us, s->n, 90), pct_ms(s->us, s->n, 99),
+           s->us[0] / 1000.0, s->us[s->n - 1] / 1000.0);
+
+    for (int i = 0; i < s->n; i++) {
+        int b = 0;
+        while (b < nedges && s->us[i] >= edges_ms[b] * 1000)
+            b++;
+        counts[b]++;
+    }
+    for (int b = 0; b <= nedges; b++) {
+        char label[32];
+        if (b < nedges)
+            snprintf(label, sizeof(label), "< %d ms", edges_ms[b]);
+        else
+            snprintf(label, sizeof(label), ">= %d ms", edges_ms[nedges - 1]);
+        printf("  %10s %5d ", label, counts[b]);
+        for (int i = 0; i < counts[b] * 50 / s->n; i++)
+            putchar('#');
+        putchar('\n');
+    }
+}
+
+// ===================== SCENARIOS =====================
+static int next_number = 0;
+
+static const char *next_token(char *buf, size_t cap)
+{
+    next_number = next_number % 90 + 1;
+    snprintf(buf, cap, "%d", next_number);
+    return buf;
+}
+
+static int64_t send_token(Kiosk *k, const char *token)
+{
+    char line[32];
+    snprintf(line, sizeof(line), ":01 1 %s\r\n", token);
+    int64_t t = now_us();
+    send_line(k, line);
+    return t;
+}
+
+static int run_singles(Kiosk *k, Series *s, int count)
+{
+    for (int i = 0; i < count; i++) {
+        char tok[8];
+        next_token(tok, sizeof(tok));
+        int64_t sent = send_token(k, tok);
+        int64_t paint = wait_paint(k, tok, "none", sent + PAINT_TIMEOUT_US);
+        if (paint < 0)
+            return -1;
+        series_add(s, sent, paint);
+        if (settle(k, sent + BULK_GAP_US - now_us()) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static int run_bursts(Kiosk *k, Series *s, int count)
+{
+    for (int i = 0; i < count; i++) {
+        char tok[8];
+        int64_t sent = 0;
+        for (int j = 0; j < BURST_TOKENS; j++) {
+            if (j > 0 && settle(k, BURST_SPACING_US) < 0)
+                return -1;
+            sent = send_token(k, next_token(tok, sizeof(tok)));
+        }
+        int64_t paint = wait_paint(k, tok, "none", sent + PAINT_TIMEOUT_US);
+        if (paint < 0)
+            return -1;
+        series_add(s, sent, paint);
+        if (settle(k, BULK_GAP_US) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static int run_overlays(Kiosk *k, Series *show, Series *hide, Series *game_over, int count)
+{
+    for (int i = 0; i < count; i++) {
+        int64_t sent = now_us();
+        send_line(k, ":00 3 7A\r\n");
+        int64_t paint = wait_paint(k, NULL, "congrats", sent + PAINT_TIMEOUT_US);
+        if (paint < 0)
+            return -1;
+        series_add(show, sent, paint);
+        if (settle(k, 300000) < 0)
+            return -1;
+
+        sent = now_us();
+        send_line(k, ":00 3 7B\r\n");
+        paint = wait_paint(k, NULL, "none", sent + PAINT_TIMEOUT_US);
+        if (paint < 0)
+            return -1;
+        series_add(hide, sent, paint);
+        if (settle(k, 300000) < 0)
+            return -1;
+
+        sent = now_us();
+        send_line(k, ":00 3 6A\r\n");
+        paint = wait_paint(k, NULL, "game-over", sent + PAINT_TIMEOUT_US);
+        if (paint < 0)
+            return -1;
+        series_add(game_over, sent, paint);
+        if (settle(k, 300000) < 0)
+            return -1;
+
+        // A new game's first token takes the kiosk off the game-over screen
+        char tok[8];
+        sent = send_token(k, next_token(tok, sizeof(tok)));
+        if (wait_paint(k, tok, "none", sent + PAINT_TIMEOUT_US) < 0 ||
+            settle(k, BULK_GAP_US) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+// ===================== MAIN =====================
+int main(int argc, char *argv[])
+{
+    static Series singles = { .name = "single draw" };
+    static Series bursts = { .name = "burst of 5, last number shown" };
+    static Series show = { .name = "overlay show (7A congratulations)" };
+    static Series hide = { .name = "overlay exit (7B)" };
+    static Series game_over = { .name = "game over (6A)" };
+    int nsingles = 40, nbursts = 5, noverlays = 10;
+    Kiosk k;
+
+    if (argc < 2 || argc > 5) {
+        fprintf(stderr, "usage: %s KIOSK_BINARY [SINGLES [BURSTS [OVERLAYS]]]\n", argv[0]);
+        return 2;
+    }
+    if (argc > 2) nsingles = atoi(argv[2]);
+    if (argc > 3) nbursts = atoi(argv[3]);
+    if (argc > 4) noverlays = atoi(argv[4]);
+
+    signal(SIGPIPE, SIG_IGN);
+    if (kiosk_start(&k, argv[1]) < 0)
+        return 1;
+
+    // First painted frame, then one token to leave "Please wait"
+    int64_t t0 = now_us();
+    int64_t first = wait_paint(&k, NULL, NULL, t0 + START_TIMEOUT_US);
+    if (first <= 0) {
+        fprintf(stderr, "no frame from the kiosk (is AURUM_LATENCY_TRACE supported?)\n");
+        kiosk_stop(&k);
+        return 1;
+    }
+    printf("first frame %.0f ms after launch\n", (first - t0) / 1000.0);
+
+    char tok[8];
+    int64_t sent = send_token(&k, next_token(tok, sizeof(tok)));
+    int64_t paint = wait_paint(&k, tok, "none", sent + START_TIMEOUT_US);
+    if (paint > 0)
+        printf("first token shown after %.1f ms (tiles may still be warming up)\n",
+               (paint - sent) / 1000.0);
+
+    int rc = 0;
+    if (paint <= 0 || settle(&k, 2000000) < 0 ||
+        run_singles(&k, &singles, nsingles) < 0 ||
+        run_bursts(&k, &bursts, nbursts) < 0 ||
+        run_overlays(&k, &show, &hide, &game_over, noverlays) < 0) {
+        fprintf(stderr, "kiosk stopped responding\n");
+        rc = 1;
+    }
+
+    series_report(&singles);
+    series_report(&bursts);
+    series_report(&show);
+    series_report(&hide);
+    series_report(&game_over);
+
+    kiosk_stop(&k);
+    return rc;
+}
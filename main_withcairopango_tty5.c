@@ -20,9 +20,21 @@
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include <sys/socket.h>
-#include <sys/un.h>
 #include <time.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <glib-unix.h>
+
+#include "aurum_protocol.h"
+#include "aurum_queue.h"
+#include "aurum_serial.h"
+#include "aurum_vt.h"
+#include "aurum_mpv.h"
+#include "aurum_tile.h"
+#include "aurum_layout.h"
+#include "aurum_overlay.h"
+#include "aurum_record.h"
 
 // ===================== GLOBAL SERIAL =====================
 int serial_fd = -1;
@@ -30,136 +42,335 @@ pthread_mutex_t serial_lock = PTHREAD_MUTEX_INITIALIZER;
 
 // Forward declaration (required)
 static gboolean refresh_images_on_ui(gpointer user_data);
-
-// ===================== GIF CONTROL FLAGS =====================
-static gboolean gif_playing = FALSE;
-static gulong gif_draw_handler_id = 0;
+static void tiles_request_missing(void);
+static void compositor_damage_slot(int slot);
+static void ui_schedule_update(void);
+
+// ===================== OVERLAYS =====================
+typedef enum {
+    OVERLAY_NONE,
+    OVERLAY_PLEASE_WAIT,
+    OVERLAY_GAME_OVER,
+    OVERLAY_CONGRATS,
+    OVERLAY_COUNT
+} OverlayKind;
+
+typedef enum {
+    OVERLAY_BACKEND_INPROCESS,   // resident animations drawn in the main window
+    OVERLAY_BACKEND_VT,          // mpv screens on tty2/tty4/tty5
+} OverlayBackend;
+
+static OverlayKind active_overlay = OVERLAY_NONE;
+static OverlayBackend overlay_backend = OVERLAY_BACKEND_INPROCESS;
+static gboolean overlay_on_vt = FALSE;   // active overlay is an mpv VT screen
+
+static void overlay_show(OverlayKind kind);
+static void overlay_hide(void);
+static void mpv_load_gif(const char *gif);
+static void ticker_start(void);
 
 // ===================== Widgets =====================
 GtkWidget *window;
-GtkWidget *top_label;
-GtkWidget *current_image, *previous_image, *preceding_image;
-GtkWidget *top_pane, *outermost, *outer, *inner;
-GtkWidget *ticker_fixed, *ticker_label;
-GtkWidget *gif_area = NULL;
-static gboolean tty2_active = FALSE;
-static gboolean tty4_active = FALSE;
-static gboolean tty5_active = FALSE;  // NEW: TTY5 for "Please wait..."
-int ticker_x = 0;
-int ticker_width = 0;
-int ticker_area_width = 0;
-guint ticker_timer_id = 0;
-
-static int flash_count = 0;
-static guint flash_timer_id = 0;   
-static guint flash_delay_id = 0;   
+GtkWidget *compositor;
+static gboolean ticker_visible = TRUE;
+
+// Format of every cached surface: tiles, overlay frames, ticker strip.
+// All are opaque, so no alpha channel is needed (AURUM_PIXEL_FORMAT).
+static cairo_format_t pixel_format = CAIRO_FORMAT_RGB24;
+
+// ===================== ANIMATION SCHEDULER =====================
+/*
+ * Every timed effect (ticker scroll, overlay frames, flash pulse, bulk
+ * finish) is an Anim with a due time. One frame-clock tick callback runs
+ * all that are due, so they land on the same vsync. When the nearest
+ * deadline is more than a frame away the tick callback is dropped and a
+ * single timeout brings it back a frame early; with nothing scheduled the
+ * kiosk does not wake at all. Step costs are summed per tick and logged
+ * every ANIM_REPORT_TICKS ticks.
+ */
+#define ANIM_MAX 8
+#define ANIM_FRAME_US 16667
+#define ANIM_REPORT_TICKS 3600      // ~1 min of continuous animation
+
+// Returns the next due time (now_us + 1 = next frame), or 0 when done.
+// due_us is when this step was scheduled, for drift-free periods.
+typedef gint64 (*AnimStepFn)(gint64 now_us, gint64 due_us);
+
+typedef struct {
+    const char *name;
+    AnimStepFn step;
+    gint64 due_us;              // 0 = idle
+    gboolean registered;
+    unsigned long steps;        // since the last report
+    gint64 total_us;
+    gint64 max_us;
+} Anim;
+
+static Anim *anim_list[ANIM_MAX];
+static int anim_count = 0;
+static guint anim_tick_id = 0;
+static guint anim_wake_id = 0;
+static unsigned long anim_ticks = 0;
+static gint64 anim_tick_total_us = 0;
+static gint64 anim_tick_max_us = 0;
+
+static gint64 anim_next_due(void)
+{
+    gint64 next = 0;
+    for (int i = 0; i < anim_count; i++) {
+        gint64 due = anim_list[i]->due_us;
+        if (due && (!next || due < next))
+            next = due;
+    }
+    return next;
+}
+
+static void anim_report(void)
+{
+    GString *line = g_string_new(NULL);
+
+    g_string_append_printf(line, "Anim: %lu ticks, mean %.0f us, max %.0f us;",
+                           anim_ticks, (double)anim_tick_total_us / anim_ticks,
+                           (double)anim_tick_max_us);
+    for (int i = 0; i < anim_count; i++) {
+        Anim *a = anim_list[i];
+        if (a->steps)
+            g_string_append_printf(line, " %s %lux%.0f us (max %.0f)", a->name,
+                                   a->steps, (double)a->total_us / a->steps,
+                                   (double)a->max_us);
+        a->steps = 0;
+        a->total_us = a->max_us = 0;
+    }
+    g_print("%s\n", line->str);
+    g_string_free(line, TRUE);
+
+    anim_ticks = 0;
+    anim_tick_total_us = anim_tick_max_us = 0;
+}
+
+static gboolean anim_wake(gpointer data);
+
+static gboolean anim_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer data)
+{
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+    gint64 t0 = g_get_monotonic_time();
+
+    for (int i = 0; i < anim_count; i++) {
+        Anim *a = anim_list[i];
+        gint64 due = a->due_us;
+        if (!due || due > now)
+            continue;
+
+        gint64 s0 = g_get_monotonic_time();
+        a->due_us = 0;              // a step may restart itself
+        gint64 next = a->step(now, due);
+        if (next)
+            a->due_us = next;
+
+        gint64 cost = g_get_monotonic_time() - s0;
+        a->steps++;
+        a->total_us += cost;
+        if (cost > a->max_us) a->max_us = cost;
+    }
+
+    gint64 cost = g_get_monotonic_time() - t0;
+    anim_ticks++;
+    anim_tick_total_us += cost;
+    if (cost > anim_tick_max_us) anim_tick_max_us = cost;
+    if (anim_ticks >= ANIM_REPORT_TICKS)
+        anim_report();
+
+    gint64 next = anim_next_due();
+    if (next && next - now <= ANIM_FRAME_US)
+        return G_SOURCE_CONTINUE;
+
+    anim_tick_id = 0;
+    if (next)
+        anim_wake_id = g_timeout_add((guint)((next - now - ANIM_FRAME_US) / 1000),
+                                     anim_wake, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+// Outside a tick: run on the frame clock if something is due within a
+// frame, otherwise sleep until a frame before the nearest deadline
+static void anim_arm(void)
+{
+    if (anim_tick_id || !compositor)
+        return;                     // a running tick re-evaluates at its end
+
+    if (anim_wake_id) {
+        g_source_remove(anim_wake_id);
+        anim_wake_id = 0;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    gint64 next = anim_next_due();
+    if (!next)
+        return;
+
+    if (next - now <= ANIM_FRAME_US)
+        anim_tick_id = gtk_widget_add_tick_callback(compositor, anim_tick,
+                                                    NULL, NULL);
+    else
+        anim_wake_id = g_timeout_add((guint)((next - now - ANIM_FRAME_US) / 1000),
+                                     anim_wake, NULL);
+}
+
+// A frame before the deadline: hand over to the frame clock
+static gboolean anim_wake(gpointer data)
+{
+    anim_wake_id = 0;
+    if (!anim_tick_id && anim_next_due())
+        anim_tick_id = gtk_widget_add_tick_callback(compositor, anim_tick,
+                                                    NULL, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+static void anim_start(Anim *a, gint64 due_us)
+{
+    if (!a->registered) {
+        g_assert(anim_count < ANIM_MAX);
+        anim_list[anim_count++] = a;
+        a->registered = TRUE;
+    }
+    a->due_us = MAX(due_us, 1);
+    anim_arm();
+}
+
+static void anim_stop(Anim *a)
+{
+    a->due_us = 0;                  // a stale wake-up finds nothing due
+}
+
+static gboolean anim_active(const Anim *a)
+{
+    return a->due_us != 0;
+}
+
+static int flash_count = 0;         // -1 while waiting for the first pulse
 static gboolean number_visible = TRUE;
 
 // ===================== BULK TOKEN DETECTION & STATE =====================
-static struct timespec last_token_time = {0, 0};
+static gint64 last_token_us = 0;       // arrival time of the previous token
 #define BULK_TOKEN_THRESHOLD_MS 500  // Tokens within 500ms = bulk
 #define BULK_FINISH_DELAY_MS 4000    // Wait 4 seconds after last token before finishing bulk
 static gboolean bulk_loading = FALSE;
 static gboolean first_token_received = FALSE;
-static guint bulk_finish_timer_id = 0;
 static gboolean first_ever_token = TRUE;  // Track very first token for startup flash
 
-// ===================== GIF Player Struct =====================
-typedef struct {
-    GdkPixbufAnimation *animation;
-    GdkPixbufAnimationIter *iter;
-    guint timeout_id;
-    GTimer *timer;
-} GifPlayer;
-
-static GifPlayer *gif_player = NULL;
+// Numbers drawn so far this game (bit n = number n), from tokens or "$S"
+static uint64_t drawn_numbers[2] = {0, 0};
+static int drawn_count = 0;
 
 // ===================== TOKENS =====================
 char current_token[32] = "--";
 char previous_token[32] = "--";
 char preceding_token[32] = "--";
 
-static gboolean flash_opacity_callback(gpointer data) {
-    if (flash_count >= 6) { 
+// Flash only touches the current tile: both variants are already cached,
+// so a toggle is a flag flip plus a redraw of that one widget.
+#define FLASH_DELAY_MS 300
+#define FLASH_PULSE_MS 400          // same 400 ms blink the g_timeout version used
+#define FLASH_TOGGLES 6
+
+static gint64 flash_step(gint64 now_us, gint64 due_us)
+{
+    if (flash_count < 0) {
+        // "Number on" and "number off" tiles should be ready for the pulses
+        flash_count = 0;
+        tiles_request_missing();
+        return due_us + FLASH_PULSE_MS * 1000;
+    }
+
+    if (flash_count >= FLASH_TOGGLES) {
         number_visible = TRUE; // Ensure visible at the end
-        refresh_images_on_ui(NULL);
-        flash_timer_id = 0;
-        return G_SOURCE_REMOVE;
+        ui_schedule_update();
+        return 0;
     }
 
-    // Toggle the number visibility flag and redraw the canvas
+    // Toggle the number visibility flag and redraw the current tile
     number_visible = !number_visible;
-    refresh_images_on_ui(NULL);
+    ui_schedule_update();
 
     flash_count++;
-    return G_SOURCE_CONTINUE;
+    return due_us + FLASH_PULSE_MS * 1000;
 }
 
-static gboolean trigger_flash_after_delay(gpointer data) {
-    flash_delay_id = 0;
-    flash_count = 0;
-    if (flash_timer_id > 0) g_source_remove(flash_timer_id);
-    
-    // Pulse every 400ms for a snappier look
-    flash_timer_id = g_timeout_add(400, flash_opacity_callback, NULL);
-    return G_SOURCE_REMOVE;
+static Anim flash_anim = { "flash", flash_step };
+
+static void restart_flash(void)
+{
+    flash_count = -1;
+    anim_start(&flash_anim, g_get_monotonic_time() + FLASH_DELAY_MS * 1000);
+}
+
+// ===================== VT HELPERS =====================
+// Serial events are applied on the GTK main loop, so VT switches and
+// mpv commands must never block it.
+// Console opened once; switches run on the manager's worker thread and
+// are confirmed with VT_GETSTATE, so no double chvt is needed. A switch
+// that has not taken effect within AURUM_VT_SWITCH_TIMEOUT_US gets chvt.
+static AurumVt vt_manager;
+
+static void vt_switch_done(int vt, AurumVtResult result,
+                           int64_t queued_us, int64_t switch_us, void *user)
+{
+    g_print("VT %d %s: %.1f ms (queued %.1f ms)\n", vt,
+            result == AURUM_VT_OK ? "active" :
+            result == AURUM_VT_FALLBACK ? "active via chvt" : "switch FAILED",
+            switch_us / 1000.0, queued_us / 1000.0);
+}
+
+static void switch_to_tty1(void) {
+    aurum_vt_switch(&vt_manager, 1);
 }
 
-// ===================== TTY5 PLEASE WAIT HELPERS =====================
-static void show_please_wait_tty5(void) {
-    g_print("Switching to TTY5 (Please wait...)\n");
-    tty5_active = TRUE;
-    system("sudo chvt 5");
+// ===================== PLEASE WAIT HELPERS =====================
+static void show_please_wait(void) {
+    if (active_overlay == OVERLAY_PLEASE_WAIT)
+        return;
+    g_print("Showing \"Please wait...\"\n");
+    overlay_show(OVERLAY_PLEASE_WAIT);
 }
 
-static void hide_please_wait_return_tty1(void) {
-    if (tty5_active) {
-        g_print("Returning to TTY1 from TTY5\n");
-        system("sudo chvt 1");
-        usleep(150000);
-        system("sudo chvt 1");  // Double switch for reliability
-        tty5_active = FALSE;
+static void hide_please_wait(void) {
+    if (active_overlay == OVERLAY_PLEASE_WAIT) {
+        g_print("Hiding \"Please wait...\"\n");
+        overlay_hide();
     }
 }
 
 // ===================== BULK LOADING FINISH HANDLER =====================
-static gboolean finish_bulk_loading(gpointer data) {
+static void finish_bulk_loading(void) {
     bulk_loading = FALSE;
-    bulk_finish_timer_id = 0;
     
-    // Return to TTY1 from TTY5
-    hide_please_wait_return_tty1();
-    
-    // Show token display area and token widgets
-    if (outermost)
-        gtk_widget_show(outermost);
-    gtk_widget_show(current_image);
-    gtk_widget_show(previous_image);
-    gtk_widget_show(preceding_image);
+    // Back to the token screen
+    hide_please_wait();
     
     // Refresh token images to display actual numbers
     number_visible = TRUE;
-    g_idle_add(refresh_images_on_ui, NULL);
+    ui_schedule_update();
     
     // If this is the very first token on startup, flash it
     if (first_ever_token) {
         first_ever_token = FALSE;  // Clear flag
-        
-        if (flash_timer_id > 0) {
-            g_source_remove(flash_timer_id);
-            flash_timer_id = 0;
-        }
-        if (flash_delay_id > 0)
-            g_source_remove(flash_delay_id);
-        
-        flash_delay_id = g_timeout_add(300, trigger_flash_after_delay, NULL);
+        restart_flash();
     }
     // Otherwise it's history reload - no flash
-    
-    return G_SOURCE_REMOVE;
 }
 
+static gint64 bulk_finish_step(gint64 now_us, gint64 due_us)
+{
+    finish_bulk_loading();
+    return 0;
+}
+
+static Anim bulk_finish_anim = { "bulk-finish", bulk_finish_step };
+
 // ===================== CONFIG READER =====================
+// AURUM_CONFIG in the environment points elsewhere (test harnesses)
+static const char *config_path = "/boot/firmware/aurum.txt";
+
 static char *read_config_value(const char *path, const char *key) {
     FILE *f = fopen(path, "r");
     if (!f) return NULL;
@@ -231,443 +442,1221 @@ static void clear_tokens(void)
 }
 
 // ===========================================================
-//                GIF PLAYER IMPLEMENTATION
+//                OVERLAY ENGINE
 // ===========================================================
+/*
+ * The "Please wait", game-over and congratulations animations are loaded
+ * once at start-up and stay resident. Showing one is a state change plus
+ * a full compositor redraw, so it is on screen the next frame. Each frame
+ * schedules the overlay anim for the next frame's deadline, so the kiosk
+ * wakes once per frame shown and not at all during long frames.
+ * AURUM_OVERLAY_BACKEND=vt keeps the old mpv screens on separate VTs.
+ *
+ * Frame cache: every frame is scaled once to the window height into a
+ * cairo surface and replayed as a plain blit on a timeline built from the
+ * GIF's own delays. Surfaces are rebuilt only when the window size
+ * changes. Animations that do not fit AURUM_GIF_CACHE_MB fall back to
+ * scaling the live GdkPixbufAnimationIter frame on every draw.
+ */
+#define OVERLAY_DIR "/home/pi/KIOSK/"
+#define OVERLAY_CACHE_DEFAULT_MB 128
+#define OVERLAY_MAX_FRAMES 512
+
+static const char *overlay_dir = OVERLAY_DIR;    // AURUM_OVERLAY_DIR, with trailing /
 
-static gboolean gif_player_advance(gpointer data) {
-    if (!gif_player || !gif_player->iter || !gif_playing)
-        return G_SOURCE_REMOVE;
+typedef struct {
+    const char *file;
+    int vt;                          // VT of the mpv screen (vt backend)
+    GdkPixbufAnimation *animation;
+    GdkPixbufAnimationIter *iter;    // live (uncached) playback
+
+    // Timeline, read once at load
+    int nframes;                     // 0 = not cacheable, always live
+    int *end_ms;                     // end of frame k within one loop
+    GdkPixbufAnimationIter *scan;    // random access to source frames
+    gint64 scan_origin_us;           // wall clock the scan iter started at
+
+    // Pre-scaled frames for the current window size
+    AurumFrameCache cache;           // filled on first use / idle prefill
+    gint64 start_us;
+    int frame;
+} OverlayAnim;
+
+static OverlayAnim overlays[OVERLAY_COUNT] = {
+    [OVERLAY_PLEASE_WAIT] = { .file = "Please_wait.gif",      .vt = 5 },
+    [OVERLAY_GAME_OVER]   = { .file = "gameover.gif",         .vt = 2 },
+    [OVERLAY_CONGRATS]    = { .file = "congratulations1.gif", .vt = 4 },
+};
+
+static unsigned long overlay_wakeups = 0;
+static unsigned long overlay_frames_shown = 0;
+static guint overlay_prefill_id = 0;
+static gsize overlay_cache_budget = (gsize)OVERLAY_CACHE_DEFAULT_MB * 1024 * 1024;
+
+static gboolean overlay_visible(void)
+{
+    return active_overlay != OVERLAY_NONE && !overlay_on_vt;
+}
 
-    double elapsed_ms = g_timer_elapsed(gif_player->timer, NULL) * 1000.0;
-    int delay = gdk_pixbuf_animation_iter_get_delay_time(gif_player->iter);
-    
-    if (delay < 0) delay = 100; // Default delay for static images or end of animation
-    
-    if (elapsed_ms >= delay) {
-        gdk_pixbuf_animation_iter_advance(gif_player->iter, NULL);
-        gtk_widget_queue_draw(gif_area);
-        g_timer_start(gif_player->timer);
+/* ---------- Timeline ---------- */
+
+// Number of image blocks in a GIF file, or 0 if it is not a GIF
+static int gif_count_frames(const char *path)
+{
+    gchar *data;
+    gsize len;
+    int frames = 0;
+
+    if (!g_file_get_contents(path, &data, &len, NULL))
+        return 0;
+
+    const guchar *d = (const guchar *)data;
+    gsize i = 13;
+    if (len < 13 || memcmp(d, "GIF8", 4) != 0) {
+        g_free(data);
+        return 0;
     }
-    
-    return G_SOURCE_CONTINUE;
+    if (d[10] & 0x80)
+        i += 3u << ((d[10] & 7) + 1);           // global colour table
+
+    while (i < len) {
+        if (d[i] == 0x21 && i + 1 < len) {      // extension
+            i += 2;
+        } else if (d[i] == 0x2C && i + 10 < len) {  // image descriptor
+            guchar flags = d[i + 9];
+            frames++;
+            i += 10;
+            if (flags & 0x80)
+                i += 3u << ((flags & 7) + 1);   // local colour table
+            i++;                                // LZW minimum code size
+        } else {
+            break;                              // trailer or garbage
+        }
+        while (i < len && d[i] != 0)            // data sub-blocks
+            i += d[i] + 1;
+        i++;
+    }
+
+    g_free(data);
+    return frames;
 }
 
-static gboolean gif_player_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data) {
-    if (!gif_playing || !gif_player || !gif_player->animation)
-        return FALSE;
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS   // the iter API still takes GTimeVal
 
-    GdkPixbuf *frame = gdk_pixbuf_animation_iter_get_pixbuf(gif_player->iter);
-    if (!frame) return FALSE;
+// Point ms into the scan iter's timeline, as the GTimeVal it wants
+static GTimeVal overlay_scan_time(const OverlayAnim *a, int ms)
+{
+    gint64 us = a->scan_origin_us + (gint64)ms * 1000;
+    GTimeVal t = { (glong)(us / G_USEC_PER_SEC), (glong)(us % G_USEC_PER_SEC) };
+    return t;
+}
 
-    int W = gtk_widget_get_allocated_width(widget);
-    int H = gtk_widget_get_allocated_height(widget);
-    int fw = gdk_pixbuf_get_width(frame);
-    int fh = gdk_pixbuf_get_height(frame);
+static GdkPixbuf *overlay_source_frame(OverlayAnim *a, int k)
+{
+    GTimeVal t = overlay_scan_time(a, k > 0 ? a->end_ms[k - 1] : 0);
+    gdk_pixbuf_animation_iter_advance(a->scan, &t);
+    return gdk_pixbuf_animation_iter_get_pixbuf(a->scan);
+}
 
-    cairo_set_source_rgb(cr, 0, 0, 0);
-    cairo_paint(cr);
+// Walk one loop at the GIF's own delays to record when each frame ends
+static void overlay_read_timeline(OverlayAnim *a, const char *path)
+{
+    int n = gif_count_frames(path);
+    if (n <= 0 || n > OVERLAY_MAX_FRAMES)
+        return;
 
-    double scale = (double)H / fh;
-    int scaled_w = fw * scale;
-    int x_offset = (W - scaled_w) / 2;
+    a->scan_origin_us = g_get_real_time();
+    GTimeVal origin = overlay_scan_time(a, 0);
+    a->scan = gdk_pixbuf_animation_get_iter(a->animation, &origin);
+    a->end_ms = g_new0(int, n);
 
-    cairo_save(cr);
-    cairo_translate(cr, x_offset, 0);
-    cairo_scale(cr, scale, scale);
-    gdk_cairo_set_source_pixbuf(cr, frame, 0, 0);
-    cairo_paint(cr);
-    cairo_restore(cr);
+    int t = 0;
+    for (int k = 0; k < n; k++) {
+        GTimeVal at = overlay_scan_time(a, t);
+        gdk_pixbuf_animation_iter_advance(a->scan, &at);
 
-    return FALSE;
+        int delay = gdk_pixbuf_animation_iter_get_delay_time(a->scan);
+        if (delay <= 0) delay = 100;    // static image / last frame: mpv looped anyway
+        t += delay;
+        a->end_ms[k] = t;
+    }
+    a->nframes = n;
 }
 
-static void gif_player_cleanup(void) {
-    if (!gif_player) return;
+G_GNUC_END_IGNORE_DEPRECATIONS
 
-    if (gif_player->timeout_id)
-        g_source_remove(gif_player->timeout_id);
+static void overlay_load_all(void)
+{
+    for (int k = OVERLAY_NONE + 1; k < OVERLAY_COUNT; k++) {
+        OverlayAnim *a = &overlays[k];
+        gchar *path = g_strconcat(overlay_dir, a->file, NULL);
+        GError *error = NULL;
+
+        a->animation = gdk_pixbuf_animation_new_from_file(path, &error);
+        if (!a->animation) {
+            g_printerr("Overlay load error (%s): %s, will use VT %d\n", path,
+                       error ? error->message : "unknown", a->vt);
+            if (error) g_error_free(error);
+        } else {
+            overlay_read_timeline(a, path);
+        }
+        g_free(path);
+    }
+}
 
-    if (gif_player->animation)
-        g_object_unref(gif_player->animation);
+/* ---------- Frame cache ---------- */
 
-    if (gif_player->iter)
-        g_object_unref(gif_player->iter);
+static gboolean overlay_cached(const OverlayAnim *a)
+{
+    return a->cache.frames != NULL;
+}
 
-    if (gif_player->timer)
-        g_timer_destroy(gif_player->timer);
+static cairo_surface_t *overlay_cached_frame(OverlayAnim *a, int k)
+{
+    if (a->cache.frames[k])
+        return a->cache.frames[k];
+    return aurum_frame_cache_fill(&a->cache, k, overlay_source_frame(a, k));
+}
 
-    g_free(gif_player);
-    gif_player = NULL;
+// Fill one missing frame per idle pass, active overlay first
+static gboolean overlay_prefill_cb(gpointer data)
+{
+    for (int pass = 0; pass < 2; pass++) {
+        for (int kind = OVERLAY_NONE + 1; kind < OVERLAY_COUNT; kind++) {
+            if ((pass == 0) != (kind == (int)active_overlay))
+                continue;
+            OverlayAnim *a = &overlays[kind];
+            if (!overlay_cached(a))
+                continue;
+            for (int k = 0; k < a->nframes; k++) {
+                if (!a->cache.frames[k]) {
+                    overlay_cached_frame(a, k);
+                    return G_SOURCE_CONTINUE;
+                }
+            }
+        }
+    }
+    overlay_prefill_id = 0;
+    return G_SOURCE_REMOVE;
 }
 
-// ===================== HIDE GIF (MODE A) =====================
-static gboolean hide_overlay_gif(gpointer user_data) {
-    g_print("Hiding GIF overlay...\n");
+// New window size: drop old surfaces and decide what fits the budget,
+// cheapest animations first so as many as possible are cached
+static void overlay_cache_resize(int W, int H)
+{
+    int order[OVERLAY_COUNT];
+    gsize cost[OVERLAY_COUNT] = { 0 };
+    int n = 0;
+
+    for (int kind = OVERLAY_NONE + 1; kind < OVERLAY_COUNT; kind++) {
+        OverlayAnim *a = &overlays[kind];
+        aurum_frame_cache_clear(&a->cache);
+        if (!a->animation || a->nframes == 0 || H <= 0)
+            continue;
+
+        aurum_frame_cache_fit(&a->cache, a->nframes,
+                              gdk_pixbuf_animation_get_width(a->animation),
+                              gdk_pixbuf_animation_get_height(a->animation),
+                              W, H, pixel_format);
+        cost[kind] = aurum_frame_cache_bytes(&a->cache);
+
+        int i = n++;
+        while (i > 0 && cost[order[i - 1]] > cost[kind]) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = kind;
+    }
 
-    gif_playing = FALSE;
+    gsize used = 0;
+    for (int i = 0; i < n; i++) {
+        OverlayAnim *a = &overlays[order[i]];
+        if (used + cost[order[i]] > overlay_cache_budget) {
+            g_print("Overlay %s: %zu MB at %dx%d exceeds cache, scaling live\n",
+                    a->file, cost[order[i]] >> 20, a->cache.w, a->cache.h);
+            continue;
+        }
+        used += cost[order[i]];
+        aurum_frame_cache_alloc(&a->cache);
+        g_print("Overlay %s: %d frames cached at %dx%d (%zu MB)\n",
+                a->file, a->nframes, a->cache.w, a->cache.h, cost[order[i]] >> 20);
+    }
+
+    if (used > 0 && !overlay_prefill_id)
+        overlay_prefill_id = g_idle_add_full(G_PRIORITY_LOW, overlay_prefill_cb,
+                                             NULL, NULL);
+}
 
-    // Stop animation timeouts
-    gif_player_cleanup();
+/* ---------- Playback ---------- */
 
-    // Disconnect draw handler (VERY important)
-    if (gif_draw_handler_id != 0) {
-        g_signal_handler_disconnect(gif_area, gif_draw_handler_id);
-        gif_draw_handler_id = 0;
+// Position within one loop; the frame clock can run slightly behind start_us
+static int overlay_loop_ms(const OverlayAnim *a, gint64 now_us)
+{
+    return (int)((MAX(now_us - a->start_us, 0) / 1000) % a->end_ms[a->nframes - 1]);
+}
+
+static int overlay_frame_at(const OverlayAnim *a, gint64 now_us)
+{
+    int t = overlay_loop_ms(a, now_us);
+    int k = 0;
+
+    while (k < a->nframes - 1 && a->end_ms[k] <= t)
+        k++;
+    return k;
+}
+
+// When the frame on screen at now_us ends, or 0 for a still image
+static gint64 overlay_next_due(OverlayAnim *a, gint64 now_us)
+{
+    int delay_ms;
+
+    if (overlay_cached(a)) {
+        delay_ms = a->end_ms[overlay_frame_at(a, now_us)] - overlay_loop_ms(a, now_us);
+    } else {
+        delay_ms = gdk_pixbuf_animation_iter_get_delay_time(a->iter);
+        if (delay_ms < 0)
+            return 0;           // single frame, nothing to advance
     }
+    return now_us + MAX(delay_ms, 1) * 1000;
+}
 
-    // Force overlay to stop drawing
-    gtk_widget_set_no_show_all(gif_area, TRUE);
-    gtk_widget_hide(gif_area);
-    gtk_widget_set_no_show_all(gif_area, FALSE);
+static gint64 overlay_step(gint64 now_us, gint64 due_us)
+{
+    if (!overlay_visible())
+        return 0;
+
+    OverlayAnim *a = &overlays[active_overlay];
+    gboolean changed;
+
+    overlay_wakeups++;
+    if (overlay_cached(a)) {
+        int k = overlay_frame_at(a, now_us);
+        changed = k != a->frame;
+        a->frame = k;
+    } else {
+        changed = gdk_pixbuf_animation_iter_advance(a->iter, NULL);
+    }
 
-    // Make sure the underlying token widgets are visible
-    gtk_widget_show(current_image);
-    gtk_widget_show(previous_image);
-    gtk_widget_show(preceding_image);
-    gtk_widget_show(top_label);
-    gtk_widget_show(ticker_fixed);
-    gtk_widget_show(ticker_label);
+    if (changed) {
+        overlay_frames_shown++;
+        gtk_widget_queue_draw(compositor);
+    }
+    return overlay_next_due(a, now_us);
+}
 
-    // Force overlay stack to redraw from bottom up
-    gtk_widget_queue_draw(window);
-    gtk_widget_queue_draw(gif_area);
-    gtk_widget_queue_draw(top_pane);
+static Anim overlay_anim = { "overlay", overlay_step };
 
-    // Regenerate token images
-    g_idle_add(refresh_images_on_ui, NULL);
+static void overlay_draw(cairo_t *cr, int W, int H)
+{
+    OverlayAnim *a = &overlays[active_overlay];
 
-    return FALSE;
+    if (overlay_cached(a) && a->cache.h == H)
+        aurum_overlay_draw_frame(cr, overlay_cached_frame(a, a->frame), W, H);
+    else
+        aurum_overlay_draw_live(cr, a->iter ? gdk_pixbuf_animation_iter_get_pixbuf(a->iter)
+                                            : NULL, W, H);
 }
 
-// ===================== TTY2 GIF PLAYER =====================
-static void play_gif_on_tty2(const char *gifpath) {
-    char cmd[512];
+// Stop drawing the in-window overlay; the token screen repaints next frame
+static void overlay_engine_stop(void)
+{
+    anim_stop(&overlay_anim);
+    if (overlay_wakeups > 0)
+        g_print("Overlay: %lu frames shown in %lu wakeups\n",
+                overlay_frames_shown, overlay_wakeups);
+    overlay_wakeups = overlay_frames_shown = 0;
+    gtk_widget_queue_draw(compositor);
+    ticker_start();
+}
 
-    // Kill any previous mpv on tty2
-    system("killall -q mpv");
+// Restart the animation from its first frame and draw it next frame
+static gboolean overlay_engine_start(OverlayKind kind)
+{
+    OverlayAnim *a = &overlays[kind];
+    if (!a->animation)
+        return FALSE;
 
-    // Switch to tty2 first
-    system("sudo chvt 2");
+    a->start_us = g_get_monotonic_time();
+    a->frame = 0;
+    if (a->iter)
+        g_object_unref(a->iter);
+    a->iter = gdk_pixbuf_animation_get_iter(a->animation, NULL);
+
+    gint64 due = overlay_next_due(a, a->start_us);
+    if (due)
+        anim_start(&overlay_anim, due);
+    else
+        anim_stop(&overlay_anim);
+    gtk_widget_queue_draw(compositor);
+    return TRUE;
+}
 
-    // Build MPV command (loop forever, no audio, direct framebuffer)
-    snprintf(cmd, sizeof(cmd),
-        "mpv --really-quiet --loop --no-audio "
-        "--vo=tct --force-window=no '%s' > /dev/tty2 2>&1 &",
-        gifpath
-    );
+static void overlay_show(OverlayKind kind)
+{
+    // Already up: keep it playing rather than restart it from frame 0
+    if (kind == active_overlay)
+        return;
 
-    system(cmd);
+    if (overlay_backend == OVERLAY_BACKEND_INPROCESS && overlay_engine_start(kind)) {
+        if (overlay_on_vt)
+            switch_to_tty1();
+        active_overlay = kind;
+        overlay_on_vt = FALSE;
+        return;
+    }
 
-    // Note: We do NOT return to tty1 here.
-    // We stay on tty2 until the next token arrives.
+    // VT backend (or the animation failed to load): mpv on its own VT
+    if (overlay_visible()) {
+        active_overlay = OVERLAY_NONE;
+        overlay_engine_stop();
+    }
+    if (kind != OVERLAY_PLEASE_WAIT) {
+        gchar *path = g_strconcat(overlay_dir, overlays[kind].file, NULL);
+        mpv_load_gif(path);
+        g_free(path);
+    }
+    aurum_vt_switch(&vt_manager, overlays[kind].vt);
+    active_overlay = kind;
+    overlay_on_vt = TRUE;
 }
 
+static void overlay_hide(void)
+{
+    if (active_overlay == OVERLAY_NONE)
+        return;
 
-// ===================== SHOW GIF (MODE A) =====================
-static gboolean show_fullscreen_gif(gpointer filename_ptr) {
-    const char *filename = filename_ptr;
-    
-    g_print("Loading GIF: %s\n", filename);
+    if (overlay_on_vt)
+        switch_to_tty1();
 
-    gif_playing = TRUE;
+    active_overlay = OVERLAY_NONE;
+    overlay_on_vt = FALSE;
+    overlay_engine_stop();
+}
 
-    // Clean previous animation
-    gif_player_cleanup();
-    gif_player = g_new0(GifPlayer, 1);
+// ===========================================================
+//                TOKEN RENDERING (CAIRO + PANGO)
+// ===========================================================
 
-    // Load GIF
-    GError *error = NULL;
-    gif_player->animation = gdk_pixbuf_animation_new_from_file(filename, &error);
-    if (!gif_player->animation) {
-        g_printerr("GIF load error: %s\n", error ? error->message : "unknown");
-        if (error) g_error_free(error);
-        gif_playing = FALSE;
-        return FALSE;
+typedef enum {
+    SLOT_CURRENT,
+    SLOT_PREVIOUS,
+    SLOT_PRECEDING,
+    SLOT_COUNT
+} TokenSlot;
+
+// Slots index aurum_tile_styles (colours, layout fractions, fonts)
+G_STATIC_ASSERT((int)SLOT_COUNT == (int)AURUM_TILE_SLOTS);
+
+// ===========================================================
+//                   TOKEN TILE CACHE
+// ===========================================================
+/*
+ * Tiles are keyed by (slot, token, size, show_number). Tambola tokens are
+ * "--" or 1..90, so the key space per slot is tiny:
+ *   0       -> "--"
+ *   1..90   -> the number
+ *   91      -> number hidden (label only, identical for every token)
+ * Anything else (non-canonical strings) is rendered uncached.
+ * A slot's entries, and its uncached tile, are dropped whenever its
+ * widget size changes; a byte budget evicts the least recently used
+ * tiles. The default budget is deliberately small: the full set at 1080p
+ * is over 500 MB, which a 1 GB board cannot spare next to the overlay
+ * frame cache. Larger budgets are opt-in through AURUM_TILE_CACHE_MB.
+ * The cache lives on the main loop and never renders: misses are filled
+ * by the render worker below.
+ */
+#define TILE_KEY_DASH    0
+#define TILE_KEY_HIDDEN  91
+#define TILE_KEYS        92
+#define TILE_CACHE_DEFAULT_MB 64
+
+typedef struct {
+    cairo_surface_t *surface;
+    guint64 last_used;
+} TileEntry;
+
+static TileEntry tile_cache[SLOT_COUNT][TILE_KEYS];
+static cairo_surface_t *tile_uncached[SLOT_COUNT];
+static char tile_uncached_token[SLOT_COUNT][32];
+static int tile_cache_w[SLOT_COUNT], tile_cache_h[SLOT_COUNT];
+static gsize tile_cache_bytes = 0;
+static gsize tile_cache_budget = (gsize)TILE_CACHE_DEFAULT_MB * 1024 * 1024;
+static guint64 tile_cache_clock = 0;
+
+static int token_cache_key(const char *token, gboolean show_number)
+{
+    if (!show_number) return TILE_KEY_HIDDEN;
+    if (!token || strcmp(token, "--") == 0) return TILE_KEY_DASH;
+
+    // Only canonical "1".."90" map to a key, so the cached text matches
+    if (token[0] < '1' || token[0] > '9') return -1;
+    int n = token[0] - '0';
+    if (token[1]) {
+        if (token[1] < '0' || token[1] > '9' || token[2]) return -1;
+        n = n * 10 + (token[1] - '0');
     }
+    return (n >= 1 && n <= 90) ? n : -1;
+}
+
+static gsize tile_bytes(cairo_surface_t *surface)
+{
+    return (gsize)cairo_image_surface_get_stride(surface) *
+           cairo_image_surface_get_height(surface);
+}
 
-    gif_player->iter = gdk_pixbuf_animation_get_iter(gif_player->animation, NULL);
-    gif_player->timer = g_timer_new();
-    g_timer_start(gif_player->timer);
+static void tile_cache_drop(TileEntry *e)
+{
+    if (!e->surface) return;
+    tile_cache_bytes -= tile_bytes(e->surface);
+    cairo_surface_destroy(e->surface);
+    e->surface = NULL;
+}
 
-    // Install draw handler once
-    if (gif_draw_handler_id == 0) {
-        gif_draw_handler_id =
-            g_signal_connect(gif_area, "draw", G_CALLBACK(gif_player_draw), NULL);
+static void tile_cache_invalidate_slot(TokenSlot slot)
+{
+    for (int k = 0; k < TILE_KEYS; k++)
+        tile_cache_drop(&tile_cache[slot][k]);
+    if (tile_uncached[slot]) {
+        cairo_surface_destroy(tile_uncached[slot]);
+        tile_uncached[slot] = NULL;
     }
+}
 
-    gtk_widget_show(gif_area);
-    gtk_widget_queue_draw(gif_area);
+static void tile_cache_evict_to_budget(const TileEntry *keep)
+{
+    while (tile_cache_bytes > tile_cache_budget) {
+        TileEntry *oldest = NULL;
+        for (int s = 0; s < SLOT_COUNT; s++)
+            for (int k = 0; k < TILE_KEYS; k++) {
+                TileEntry *e = &tile_cache[s][k];
+                if (e->surface && e != keep &&
+                    (!oldest || e->last_used < oldest->last_used))
+                    oldest = e;
+            }
+        if (!oldest) break;
+        tile_cache_drop(oldest);
+    }
+}
 
-    // Start animation loop - will keep looping until interrupted
-    gif_player->timeout_id = g_timeout_add(10, gif_player_advance, NULL);
-    
-    return FALSE;
+// Tile size for a slot's rectangle, dropping the slot's tiles if it changed
+static void tile_cache_size(TokenSlot slot, int *w, int *h)
+{
+    if (*w < 100 || *h < 100) { *w = 600; *h = 300; }
+
+    if (*w != tile_cache_w[slot] || *h != tile_cache_h[slot]) {
+        tile_cache_invalidate_slot(slot);
+        tile_cache_w[slot] = *w;
+        tile_cache_h[slot] = *h;
+    }
+}
+
+// Cached tile, or NULL if the render worker has not produced it yet
+static cairo_surface_t *tile_cache_peek(TokenSlot slot, int w, int h,
+                                        const char *token, gboolean show_number)
+{
+    tile_cache_size(slot, &w, &h);
+
+    int key = token_cache_key(token, show_number);
+    if (key < 0) {
+        if (tile_uncached[slot] && strcmp(tile_uncached_token[slot], token) == 0)
+            return tile_uncached[slot];
+        return NULL;
+    }
+
+    TileEntry *e = &tile_cache[slot][key];
+    if (e->surface)
+        e->last_used = ++tile_cache_clock;
+    return e->surface;
+}
+
+// Takes ownership of surface; dropped if the slot has been resized since
+static void tile_cache_insert(TokenSlot slot, int w, int h, const char *token,
+                              gboolean show_number, cairo_surface_t *surface)
+{
+    if (w != tile_cache_w[slot] || h != tile_cache_h[slot]) {
+        cairo_surface_destroy(surface);
+        return;
+    }
+
+    int key = token_cache_key(token, show_number);
+    if (key < 0) {
+        if (tile_uncached[slot]) cairo_surface_destroy(tile_uncached[slot]);
+        tile_uncached[slot] = surface;
+        g_strlcpy(tile_uncached_token[slot], token, sizeof(tile_uncached_token[slot]));
+        return;
+    }
+
+    TileEntry *e = &tile_cache[slot][key];
+    tile_cache_drop(e);
+    e->surface = surface;
+    e->last_used = ++tile_cache_clock;
+    tile_cache_bytes += tile_bytes(surface);
+    tile_cache_evict_to_budget(e);
 }
 
 // ===========================================================
-//                TOKEN RENDERING (CAIRO + PANGO)
+//                   COMPOSITOR (SINGLE DRAW PASS)
 // ===========================================================
+/*
+ * One drawing area paints the top label, the three token tiles and the
+ * ticker. Region rectangles are computed once per size-allocate from the
+ * AURUM_RATIO_* config values (aurum_layout, shared with aurum_bench);
+ * updates invalidate only their own region.
+ */
+typedef struct {
+    AurumLayoutRatios ratios;
+    AurumLayout layout;
+    char *top_text;
+    PangoLayout *top_layout;
+    PangoLayout *ticker_layout;
+} Compositor;
+
+static Compositor comp = {
+    .ratios = { 0.11, 0.85, 0.71, 0.65 },   // aurum_layout_default_ratios
+};
+
+static void compositor_damage(const GdkRectangle *r)
+{
+    if (compositor && r->width > 0 && r->height > 0)
+        gtk_widget_queue_draw_area(compositor, r->x, r->y, r->width, r->height);
+}
 
-static void set_cairo_color(cairo_t *cr, const char *hex)
-{
-    unsigned r, g, b;
-    if (hex && sscanf(hex, "#%02x%02x%02x", &r, &g, &b) == 3) {
-        cairo_set_source_rgb(cr, r / 255.0, g / 255.0, b / 255.0);
-    }
-}
-
-// Render token with number or "--"
-static GdkPixbuf *render_token_pixbuf_cairo(GtkWidget *widget, 
-                                            const char *number, 
-                                            const char *label, 
-                                            const char *bg_hex, 
-                                            const char *num_hex, 
-                                            const char *lab_hex, 
-                                            double number_size_frac, 
-                                            double label_size_frac, 
-                                            double number_x_frac, 
-                                            double number_y_frac, 
-                                            double label_x_frac, 
-                                            double label_y_frac, 
-                                            const char *num_font, 
-                                            const char *lab_font, 
-                                            gboolean show_number) {
-    int w = gtk_widget_get_allocated_width(widget);
-    int h = gtk_widget_get_allocated_height(widget);
-    if (w < 100 || h < 100) { w = 600; h = 300; }
-    
-    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
-    cairo_t *cr = cairo_create(surface);
-    
-    set_cairo_color(cr, bg_hex);
-    cairo_paint(cr);
-    
-    PangoLayout *layout = pango_cairo_create_layout(cr);
-    char fontdesc[128];
-    int tw, th;
+static void compositor_damage_slot(int slot)
+{
+    compositor_damage(&comp.layout.tile[slot]);
+}
 
-    /* Draw NUMBER - Only if show_number is TRUE */
-    if (show_number) {
-        set_cairo_color(cr, num_hex);
-        snprintf(fontdesc, sizeof(fontdesc), "%s %d", num_font, (int)(h * number_size_frac));
-        PangoFontDescription *fd = pango_font_description_from_string(fontdesc);
-        pango_layout_set_font_description(layout, fd);
-        pango_layout_set_text(layout, number ? number : "--", -1);
-        pango_layout_get_pixel_size(layout, &tw, &th);
-        cairo_move_to(cr, (w / 2 + (int)(w * number_x_frac)) - tw / 2, 
-                         (h / 2 + (int)(h * number_y_frac)) - th / 2);
-        pango_cairo_show_layout(cr, layout);
-        pango_font_description_free(fd);
-    }
-
-    /* Draw LABEL - Always shown */
-    set_cairo_color(cr, lab_hex);
-    snprintf(fontdesc, sizeof(fontdesc), "%s %d", lab_font, (int)(h * label_size_frac));
-    PangoFontDescription *fd_lab = pango_font_description_from_string(fontdesc);
-    pango_layout_set_font_description(layout, fd_lab);
-    pango_layout_set_text(layout, label ? label : "", -1);
-    pango_layout_get_pixel_size(layout, &tw, &th);
-    cairo_move_to(cr, (w / 2 + (int)(w * label_x_frac)) - tw / 2, 
-                     (h / 2 + (int)(h * label_y_frac)) - th / 2);
-    pango_cairo_show_layout(cr, layout);
-    pango_font_description_free(fd_lab);
+// ===================== RENDER WORKER =====================
+/*
+ * Tiles are rendered on a worker thread with its own Pango font map, so a
+ * token update never stalls the ticker or an overlay on the main loop.
+ * The main loop posts an immutable snapshot of the tiles it is missing.
+ * A newer snapshot replaces one the worker has not started, and a worker
+ * that sees a newer one between tiles abandons the rest, so work never
+ * queues up. Finished surfaces come back through an idle callback into
+ * the tile cache; until then the slot keeps showing its previous tile.
+ */
+#define RENDER_MAX_JOBS (SLOT_COUNT + 1)   // + the current tile's flash variant
+#define RENDER_REPORT_RESULTS 100          // one "Render:" line per this many
+
+typedef struct {
+    TokenSlot slot;
+    int w, h;
+    char token[32];
+    gboolean show_number;
+    cairo_surface_t *surface;           // filled in by the worker
+} RenderJob;
+
+typedef struct {
+    guint64 gen;
+    int njobs;
+    int rendered;
+    gint64 render_us;
+    RenderJob jobs[RENDER_MAX_JOBS];
+} RenderRequest;
+
+static pthread_mutex_t render_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t render_wake = PTHREAD_COND_INITIALIZER;
+static RenderRequest *render_pending = NULL;    // posted, not yet started
+static guint64 render_gen = 0;                  // newest snapshot posted
+static unsigned long render_dropped = 0;        // stale tiles never rendered
+
+// Main loop only
+static RenderJob render_last[RENDER_MAX_JOBS];  // last snapshot posted
+static int render_last_n = 0;
+static gboolean render_in_flight = FALSE;
+static cairo_surface_t *tile_shown[SLOT_COUNT]; // what each slot shows now
+
+// Render stats since the last report (main loop only)
+static unsigned long render_results = 0;
+static unsigned long render_tiles = 0;
+static gint64 render_total_us = 0;
+static gint64 render_max_us = 0;
+
+static void render_report(void)
+{
+    g_print("Render: %lu results, %lu tiles, mean %.1f ms, max %.1f ms off the "
+            "main loop (%lu stale tiles dropped so far)\n", render_results,
+            render_tiles, render_total_us / 1000.0 / render_results,
+            render_max_us / 1000.0, render_dropped);
+    render_results = render_tiles = 0;
+    render_total_us = render_max_us = 0;
+}
+
+static gboolean render_done_cb(gpointer data)
+{
+    RenderRequest *req = data;
+    const char *tokens[SLOT_COUNT] = { current_token, previous_token, preceding_token };
+
+    for (int i = 0; i < req->njobs; i++) {
+        RenderJob *j = &req->jobs[i];
+        if (j->surface)
+            tile_cache_insert(j->slot, j->w, j->h, j->token, j->show_number,
+                              j->surface);
+    }
+    if (req->gen == render_gen)
+        render_in_flight = FALSE;
+
+    render_results++;
+    render_tiles += (unsigned long)req->rendered;
+    render_total_us += req->render_us;
+    if (req->render_us > render_max_us)
+        render_max_us = req->render_us;
+    if (render_results >= RENDER_REPORT_RESULTS)
+        render_report();
+
+    // Present every slot whose wanted tile has just arrived
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        const GdkRectangle *r = &comp.layout.tile[slot];
+        gboolean show = (slot == SLOT_CURRENT) ? number_visible : TRUE;
+        cairo_surface_t *tile = tile_cache_peek(slot, r->width, r->height,
+                                                tokens[slot], show);
+        if (tile && tile != tile_shown[slot])
+            compositor_damage_slot(slot);
+    }
 
-    g_object_unref(layout);
-    cairo_surface_flush(surface);
-    GdkPixbuf *pix = gdk_pixbuf_get_from_surface(surface, 0, 0, w, h);
-    cairo_destroy(cr);
-    cairo_surface_destroy(surface);
-    return pix;
+    g_free(req);
+    return G_SOURCE_REMOVE;
 }
 
+static void *render_thread(void *arg)
+{
+    AurumTileRenderer renderer;
+    aurum_tile_renderer_init(&renderer);
+    renderer.format = pixel_format;
+
+    // Pay fontconfig's scan and the style fonts' matching before any token
+    gint64 f0 = g_get_monotonic_time();
+    aurum_tile_prepare(&renderer, aurum_tile_styles, SLOT_COUNT, 0, 0);
+    g_print("Tile fonts ready in %.1f ms\n", (g_get_monotonic_time() - f0) / 1000.0);
+
+    for (;;) {
+        pthread_mutex_lock(&render_lock);
+        while (!render_pending)
+            pthread_cond_wait(&render_wake, &render_lock);
+        RenderRequest *req = render_pending;
+        render_pending = NULL;
+        pthread_mutex_unlock(&render_lock);
+
+        gint64 t0 = g_get_monotonic_time();
+        for (int i = 0; i < req->njobs; i++) {
+            pthread_mutex_lock(&render_lock);
+            gboolean stale = render_gen != req->gen;
+            if (stale)
+                render_dropped += req->njobs - i;
+            pthread_mutex_unlock(&render_lock);
+            if (stale)
+                break;
+
+            RenderJob *j = &req->jobs[i];
+            j->surface = aurum_tile_render(&renderer, j->w, j->h, j->token,
+                                           &aurum_tile_styles[j->slot], j->show_number);
+            req->rendered++;
+        }
+        req->render_us = g_get_monotonic_time() - t0;
 
-gboolean animate_ticker(gpointer data) {
-    ticker_x -= 2;
+        g_idle_add_full(G_PRIORITY_HIGH_IDLE, render_done_cb, req, NULL);
+    }
+    return NULL;
+}
 
-    if (ticker_x + ticker_width < 0)
-        ticker_x = ticker_area_width;
+static void render_post(const RenderJob *jobs, int njobs)
+{
+    RenderRequest *req = g_new0(RenderRequest, 1);
+    memcpy(req->jobs, jobs, njobs * sizeof(jobs[0]));
+    req->njobs = njobs;
+
+    pthread_mutex_lock(&render_lock);
+    req->gen = ++render_gen;
+    if (render_pending) {
+        render_dropped += render_pending->njobs;
+        g_free(render_pending);
+    }
+    render_pending = req;
+    pthread_cond_signal(&render_wake);
+    pthread_mutex_unlock(&render_lock);
 
-    gtk_fixed_move(GTK_FIXED(ticker_fixed), ticker_label, ticker_x, 0);
-    return G_SOURCE_CONTINUE;
+    memcpy(render_last, jobs, njobs * sizeof(jobs[0]));
+    render_last_n = njobs;
+    render_in_flight = TRUE;
 }
 
-gboolean finalize_ticker_setup(gpointer data) {
-    // Get screen width instead of container width
-    GdkScreen *screen = gdk_screen_get_default();
-    ticker_area_width = gdk_screen_get_width(screen);
-    
-    // Measure label
-    GtkRequisition label_req;
-    gtk_widget_get_preferred_size(ticker_label, NULL, &label_req);
-    ticker_width = label_req.width;
+static int render_add_missing(RenderJob *jobs, int n, TokenSlot slot,
+                              const char *token, gboolean show_number)
+{
+    const GdkRectangle *r = &comp.layout.tile[slot];
+    int w = r->width, h = r->height;
+
+    if (tile_cache_peek(slot, w, h, token, show_number))
+        return n;
+    tile_cache_size(slot, &w, &h);
+
+    RenderJob *j = &jobs[n];
+    j->slot = slot;
+    j->w = w;
+    j->h = h;
+    g_strlcpy(j->token, token, sizeof(j->token));
+    j->show_number = show_number;
+    return n + 1;
+}
 
-    if (ticker_width <= 1 || ticker_area_width <= 1)
-        return G_SOURCE_CONTINUE;
+// Ask the worker for every tile the current state needs but the cache lacks.
+// Both variants of the current tile are wanted so a flash never waits.
+static void tiles_request_missing(void)
+{
+    RenderJob jobs[RENDER_MAX_JOBS];
+    int n = 0;
+
+    memset(jobs, 0, sizeof(jobs));
+    n = render_add_missing(jobs, n, SLOT_CURRENT, current_token, number_visible);
+    n = render_add_missing(jobs, n, SLOT_CURRENT, current_token, !number_visible);
+    n = render_add_missing(jobs, n, SLOT_PREVIOUS, previous_token, TRUE);
+    n = render_add_missing(jobs, n, SLOT_PRECEDING, preceding_token, TRUE);
+    if (n == 0)
+        return;
 
-    // Start off-screen right
-    ticker_x = ticker_area_width;
-    
-    // Lock label size
-    gtk_widget_set_size_request(ticker_label, ticker_width, 60);
+    // Same snapshot already on its way: don't restart the worker
+    if (render_in_flight && n == render_last_n &&
+        memcmp(jobs, render_last, n * sizeof(jobs[0])) == 0)
+        return;
+    render_post(jobs, n);
+}
 
-    if (ticker_timer_id == 0)
-        ticker_timer_id = g_timeout_add(30, animate_ticker, NULL);
+static void render_worker_start(void)
+{
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, render_thread, NULL) != 0) {
+        perror("render thread");
+        exit(1);
+    }
+    pthread_detach(thread);
+}
 
+// ===================== TILE WARM-UP =====================
+/*
+ * Once the window has its size, every tile a game can show (each number,
+ * "--" and the hidden current tile) is pre-rendered by a small pool, one
+ * thread per core with its own renderer, while "Please wait" is up. Tiles
+ * already cached are skipped but keep their share of the budget; the rest
+ * are planned a whole number at a time (all three slots) until the budget
+ * is full. A partial warm-up is logged with what a full one needs.
+ */
+#define WARMUP_MAX_THREADS 4
+#define WARMUP_MAX_JOBS (TILE_KEYS * SLOT_COUNT)
+
+static RenderJob warmup_jobs[WARMUP_MAX_JOBS];
+static int warmup_njobs = 0;
+static atomic_int warmup_next;          // next job to claim
+static atomic_int warmup_running;       // pool threads still working, + starter
+static int warmup_nthreads = 0;
+static gint64 warmup_start_us = 0;
+static gboolean warmup_active = FALSE;
+static gboolean warmup_again = FALSE;   // resized mid warm-up
+static int warmup_left_out = 0;         // tiles over budget, rendered on demand
+
+static void tile_warmup_start(void);
+
+static gboolean warmup_done_cb(gpointer data)
+{
+    gsize bytes = 0;
+    int rendered = 0;
+
+    for (int i = 0; i < warmup_njobs; i++) {
+        RenderJob *j = &warmup_jobs[i];
+        if (!j->surface)
+            continue;
+        bytes += tile_bytes(j->surface);
+        rendered++;
+        tile_cache_insert(j->slot, j->w, j->h, j->token, j->show_number, j->surface);
+        j->surface = NULL;
+    }
+    g_print("Tile warm-up: %d tiles (%zu MB) in %.1f ms on %d threads, %s\n",
+            rendered, bytes >> 20,
+            (g_get_monotonic_time() - warmup_start_us) / 1000.0,
+            warmup_nthreads, warmup_left_out ? "PARTIAL" : "complete");
+
+    for (int slot = 0; slot < SLOT_COUNT; slot++)
+        compositor_damage_slot(slot);
+
+    warmup_active = FALSE;
+    if (warmup_again) {
+        warmup_again = FALSE;
+        tile_warmup_start();
+    }
     return G_SOURCE_REMOVE;
 }
 
+static void *warmup_thread(void *arg)
+{
+    AurumTileRenderer renderer;
+    aurum_tile_renderer_init(&renderer);
+    renderer.format = pixel_format;
+
+    int i;
+    while ((i = atomic_fetch_add(&warmup_next, 1)) < warmup_njobs) {
+        RenderJob *j = &warmup_jobs[i];
+        j->surface = aurum_tile_render(&renderer, j->w, j->h, j->token,
+                                       &aurum_tile_styles[j->slot], j->show_number);
+    }
 
+    aurum_tile_renderer_free(&renderer);
+    if (atomic_fetch_sub(&warmup_running, 1) == 1)
+        g_idle_add(warmup_done_cb, NULL);
+    return NULL;
+}
 
-static gboolean refresh_images_on_ui(gpointer user_data) {
-    // Current Image - show/hide based on number_visible flag
-    GdkPixbuf *pb1 = render_token_pixbuf_cairo(current_image, 
-        current_token, "Current Draw", 
-        "#FFDAB9", "#FF0000", "#333333", 
-        0.65, 0.15, -0.08, 0.03, -0.05, 0.41, 
-        "Liberation Sans Bold", "Liberation Sans", 
-        number_visible);
-    
-    // History images - always visible
-    GdkPixbuf *pb2 = render_token_pixbuf_cairo(previous_image, 
-        previous_token, "Previous Draw", 
-        "#FFDAB9", "#0000FF", "#555555", 
-        0.50, 0.07, -0.04, 0.03, -0.06, 0.30, 
-        "Liberation Sans Bold", "Liberation Sans", 
-        TRUE);
-        
-    GdkPixbuf *pb3 = render_token_pixbuf_cairo(preceding_image, 
-        preceding_token, "Preceding Draw", 
-        "#FFDAB9", "#3E2723", "#4F4F4F", 
-        0.65, 0.11, -0.08, -0.03, -0.05, 0.3, 
-        "Liberation Sans Bold", "Liberation Sans", 
-        TRUE);
-
-    if (pb1) { gtk_image_set_from_pixbuf(GTK_IMAGE(current_image), pb1); g_object_unref(pb1); }
-    if (pb2) { gtk_image_set_from_pixbuf(GTK_IMAGE(previous_image), pb2); g_object_unref(pb2); }
-    if (pb3) { gtk_image_set_from_pixbuf(GTK_IMAGE(preceding_image), pb3); g_object_unref(pb3); }
-    return FALSE;
+static void warmup_plan_add(TokenSlot slot, int key, int w, int h)
+{
+    RenderJob *j = &warmup_jobs[warmup_njobs++];
+    memset(j, 0, sizeof(*j));
+    j->slot = slot;
+    j->w = w;
+    j->h = h;
+    j->show_number = key != TILE_KEY_HIDDEN;
+    if (key == TILE_KEY_DASH || key == TILE_KEY_HIDDEN)
+        g_strlcpy(j->token, "--", sizeof(j->token));
+    else
+        snprintf(j->token, sizeof(j->token), "%d", key);
 }
 
+static void tile_warmup_start(void)
+{
+    if (warmup_active) {
+        warmup_again = TRUE;
+        return;
+    }
 
-// ===========================================================
-//                     PANED RESIZE LOGIC
-// ===========================================================
-static gboolean set_paned_ratios(gpointer user_data) {
+    // The full set: every key for the current tile, all but hidden elsewhere
+    int w[SLOT_COUNT], h[SLOT_COUNT];
+    gsize tile_size[SLOT_COUNT], full = 0;
+
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        w[slot] = comp.layout.tile[slot].width;
+        h[slot] = comp.layout.tile[slot].height;
+        tile_cache_size(slot, &w[slot], &h[slot]);  // drops a resized slot's tiles
+        tile_size[slot] = (gsize)cairo_format_stride_for_width(pixel_format, w[slot]) *
+                          h[slot];
+        full += tile_size[slot] * (slot == SLOT_CURRENT ? TILE_KEYS : TILE_KEYS - 1);
+    }
 
-    gtk_paned_set_wide_handle(GTK_PANED(top_pane), FALSE);
-    gtk_paned_set_wide_handle(GTK_PANED(outermost), FALSE);
-    gtk_paned_set_wide_handle(GTK_PANED(outer), FALSE);
-    gtk_paned_set_wide_handle(GTK_PANED(inner), FALSE);
+    // Hidden and "--" first, then 1..90; each number for all slots at once
+    static const int order_head[] = { TILE_KEY_HIDDEN, TILE_KEY_DASH };
+    gsize planned = tile_cache_bytes;
+    int total = 0, cached = 0;
+    warmup_njobs = 0;
+    warmup_left_out = 0;
+
+    for (int i = 0; i < 2 + 90; i++) {
+        int key = i < 2 ? order_head[i] : i - 1;
+        int first = warmup_njobs;
+        gsize bytes = 0;
+
+        for (int slot = 0; slot < SLOT_COUNT; slot++) {
+            if (key == TILE_KEY_HIDDEN && slot != SLOT_CURRENT)
+                continue;   // only the current tile is ever hidden
+            total++;
+            if (tile_cache[slot][key].surface) {
+                cached++;
+                continue;
+            }
+            warmup_plan_add(slot, key, w[slot], h[slot]);
+            bytes += tile_size[slot];
+        }
+        if (planned + bytes > tile_cache_budget) {
+            warmup_left_out += warmup_njobs - first;
+            warmup_njobs = first;       // over budget: leave it to the worker
+        } else {
+            planned += bytes;
+        }
+    }
 
-    GtkAllocation top_alloc, outermost_alloc, outer_alloc, inner_alloc;
-    gtk_widget_get_allocation(top_pane, &top_alloc);
-    gtk_widget_get_allocation(outermost, &outermost_alloc);
-    gtk_widget_get_allocation(outer, &outer_alloc);
-    gtk_widget_get_allocation(inner, &inner_alloc);
+    if (warmup_left_out)
+        g_print("Tile warm-up: PARTIAL, budget %zu MB holds %d of %d tiles "
+                "(%d cached, %d to render); %d render on first use. A full "
+                "warm-up needs AURUM_TILE_CACHE_MB=%zu\n",
+                tile_cache_budget >> 20, total - warmup_left_out, total, cached,
+                warmup_njobs, warmup_left_out, (full >> 20) + 1);
+    else
+        g_print("Tile warm-up: all %d tiles fit in %zu MB (%d cached, %d to render)\n",
+                total, tile_cache_budget >> 20, cached, warmup_njobs);
+    if (warmup_njobs == 0)
+        return;
 
-    if (top_alloc.height == 0) top_alloc.height = 100;
-    if (outermost_alloc.height == 0) outermost_alloc.height = 800;
-    if (outer_alloc.width == 0) outer_alloc.width = 1200;
-    if (inner_alloc.height == 0) inner_alloc.height = 600;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int nthreads = (int)CLAMP(cores, 1, WARMUP_MAX_THREADS);
+
+    atomic_store(&warmup_next, 0);
+    atomic_store(&warmup_running, 1);   // held by us until all are started
+    warmup_start_us = g_get_monotonic_time();
+    warmup_active = TRUE;
+    warmup_nthreads = 0;
+
+    for (int t = 0; t < nthreads; t++) {
+        pthread_t thread;
+        atomic_fetch_add(&warmup_running, 1);
+        if (pthread_create(&thread, NULL, warmup_thread, NULL) != 0) {
+            // Fewer threads: the ones already running take the remaining jobs
+            perror("warm-up thread");
+            atomic_fetch_sub(&warmup_running, 1);
+            break;
+        }
+        pthread_detach(thread);
+        warmup_nthreads++;
+    }
 
-    gtk_paned_set_position(GTK_PANED(top_pane), top_alloc.height * 0.11);
-    gtk_paned_set_position(GTK_PANED(outermost), outermost_alloc.height * 0.85);
-    gtk_paned_set_position(GTK_PANED(outer), outer_alloc.width * 0.71);
-    gtk_paned_set_position(GTK_PANED(inner), inner_alloc.height * 0.65);
+    if (warmup_nthreads == 0) {
+        warmup_active = FALSE;
+        return;
+    }
+    if (atomic_fetch_sub(&warmup_running, 1) == 1)
+        g_idle_add(warmup_done_cb, NULL);
+}
 
-    gtk_widget_show(top_label);
-    gtk_widget_show(ticker_fixed);
-    gtk_widget_show(ticker_label);
+static PangoLayout *compositor_text_layout(const char *text, const char *family,
+                                           int size)
+{
+    PangoLayout *layout = gtk_widget_create_pango_layout(compositor, text);
+    aurum_text_font(layout, family, size);
+    return layout;
+}
 
-    int top_font_size = (int)(outermost_alloc.height * 0.08 * 0.9 * PANGO_SCALE);
-    int ticker_font_size = (int)(outermost_alloc.height * 0.042 * 0.9 * PANGO_SCALE);
+// ===================== SCROLLING TICKER =====================
+/*
+ * The marquee text is rendered once into an opaque strip whenever the
+ * text or the band size changes. Scrolling is a blit of that strip at a
+ * sub-pixel offset taken from the frame clock, so it never lays out text
+ * and moves at the same speed whatever the frame rate. The ticker anim
+ * only runs while the ticker is actually on screen.
+ */
+static cairo_surface_t *ticker_strip = NULL;
+static double ticker_x = 0;         // strip position within the band
+static gint64 ticker_last_us = 0;
+
+static void ticker_render_strip(void)
+{
+    if (ticker_strip) {
+        cairo_surface_destroy(ticker_strip);
+        ticker_strip = NULL;
+    }
+    if (!comp.ticker_layout)
+        return;
 
-    const char *plain = gtk_label_get_text(GTK_LABEL(top_label));
-    if (!plain) plain = "";
+    ticker_strip = aurum_ticker_strip(comp.ticker_layout,
+                                      comp.layout.ticker_band.height, pixel_format);
+    ticker_x = comp.layout.ticker_band.width;   // start off-screen right
+}
 
-    char *escaped = g_markup_escape_text(plain, -1);
+static gint64 ticker_step(gint64 now_us, gint64 due_us)
+{
+    if (!ticker_visible || overlay_visible() || !ticker_strip)
+        return 0;                   // restarted by ticker_start()
+
+    if (ticker_last_us) {
+        // A stalled frame moves the text once, not in a visible jump
+        gint64 dt = MIN(now_us - ticker_last_us, 100000);
+        ticker_x -= dt * AURUM_TICKER_SPEED_PX_S / 1e6;
+        if (ticker_x + cairo_image_surface_get_width(ticker_strip) < 0)
+            ticker_x = comp.layout.ticker_band.width;
+        compositor_damage(&comp.layout.ticker_band);
+    }
+    ticker_last_us = now_us;
+    return now_us + 1;              // every frame
+}
 
-    char markup_top[512];
-    snprintf(markup_top, sizeof(markup_top),
-             "<span font_family='Fira Sans' weight='bold' size='%d' foreground='#8B0000'>%s</span>",
-             top_font_size, escaped);
+static Anim ticker_anim = { "ticker", ticker_step };
 
-    gtk_label_set_markup(GTK_LABEL(top_label), markup_top);
-    g_free(escaped);
+static void ticker_start(void)
+{
+    if (anim_active(&ticker_anim))
+        return;
+    ticker_last_us = 0;
+    anim_start(&ticker_anim, g_get_monotonic_time());
+}
 
-    char markup_ticker[256];
-    snprintf(markup_ticker, sizeof(markup_ticker),
-             "<span font_family='Arial' weight='bold' size='%d' foreground='#2F4F4F'>Aurum Smart Tech</span>",
-             ticker_font_size);
+static void ticker_draw(cairo_t *cr)
+{
+    aurum_ticker_blit(cr, &comp.layout.ticker_band, ticker_strip, ticker_x);
+}
 
-    gtk_label_set_markup(GTK_LABEL(ticker_label), markup_ticker);
+static void compositor_layout(int W, int H)
+{
+    aurum_layout_compute(&comp.layout, &comp.ratios, W, H);
 
-    g_idle_add(refresh_images_on_ui, NULL);
-    
-    // CRITICAL: Lock ticker_fixed to its parent's width
-    GtkAllocation parent_alloc;
-    gtk_widget_get_allocation(top_pane, &parent_alloc);  // Use top_pane width
-    if (parent_alloc.width > 100) {
-        gtk_widget_set_size_request(ticker_fixed, parent_alloc.width, 60);
+    if (comp.top_layout) g_object_unref(comp.top_layout);
+    comp.top_layout = compositor_text_layout(comp.top_text ? comp.top_text : "",
+                                             "Fira Sans", comp.layout.top_font_size);
+
+    if (comp.ticker_layout) g_object_unref(comp.ticker_layout);
+    comp.ticker_layout = compositor_text_layout(AURUM_TICKER_TEXT, AURUM_TICKER_FONT,
+                                                comp.layout.ticker_font_size);
+    ticker_render_strip();
+}
+
+static void compositor_size_allocate(GtkWidget *widget, GdkRectangle *alloc,
+                                     gpointer user_data)
+{
+    if (alloc->width == comp.layout.width && alloc->height == comp.layout.height)
+        return;
+
+    compositor_layout(alloc->width, alloc->height);
+    overlay_cache_resize(alloc->width, alloc->height);
+    tile_warmup_start();
+    ticker_start();
+}
+
+// ===================== LATENCY TRACE =====================
+/*
+ * AURUM_LATENCY_TRACE=<path> writes one line for every frame whose
+ * visible content changed:
+ *     <monotonic us> <current number, "-" while hidden> <overlay>
+ * The line is written from the frame clock's after-paint signal, once the
+ * frame has been handed to the display server, so latency_harness can
+ * compare it with the time it wrote the serial line.
+ */
+static const char *const trace_overlay_names[OVERLAY_COUNT] = {
+    [OVERLAY_NONE]        = "none",
+    [OVERLAY_PLEASE_WAIT] = "please-wait",
+    [OVERLAY_GAME_OVER]   = "game-over",
+    [OVERLAY_CONGRATS]    = "congrats",
+};
+
+static FILE *trace_file = NULL;
+static char trace_token[32] = "-";      // as painted by the last draw
+static OverlayKind trace_overlay = OVERLAY_NONE;
+static char trace_written[64] = "";
+
+static void trace_paint_token(const char *token, gboolean show)
+{
+    if (trace_file)
+        g_strlcpy(trace_token, show ? token : "-", sizeof(trace_token));
+}
+
+static void trace_after_paint(GdkFrameClock *clock, gpointer user_data)
+{
+    char state[sizeof(trace_written)];
+
+    g_snprintf(state, sizeof(state), "%s %s", trace_token,
+               trace_overlay_names[trace_overlay]);
+    if (strcmp(state, trace_written) == 0)
+        return;
+
+    g_strlcpy(trace_written, state, sizeof(trace_written));
+    fprintf(trace_file, "%lld %s\n", (long long)g_get_monotonic_time(), state);
+    fflush(trace_file);
+}
+
+// After gtk_widget_show_all(): the frame clock exists once realized
+static void trace_start(const char *path)
+{
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(compositor);
+
+    trace_file = fopen(path, "w");
+    if (!trace_file || !clock) {
+        g_printerr("Latency trace %s unavailable\n", path);
+        if (trace_file) fclose(trace_file);
+        trace_file = NULL;
+        return;
     }
-    
-    // DON'T set size_request on ticker_label yet - let it measure naturally first
-    gtk_widget_set_size_request(ticker_label, -1, 60);
-    
-    g_timeout_add(100, finalize_ticker_setup, NULL);
-    return G_SOURCE_REMOVE;
+    g_signal_connect(clock, "after-paint", G_CALLBACK(trace_after_paint), NULL);
+    g_print("Latency trace: %s\n", path);
 }
 
-static void isolate_ticker_with_overlay(void) {
-    GtkWidget *old_parent = gtk_widget_get_parent(ticker_fixed);
-    if (!old_parent) return;
-    
-    GtkWidget *window_child = gtk_bin_get_child(GTK_BIN(window));
-    
-    GtkWidget *overlay = gtk_overlay_new();
-    
-    g_object_ref(window_child);
-    gtk_container_remove(GTK_CONTAINER(window), window_child);
-    gtk_container_add(GTK_CONTAINER(overlay), window_child);
-    g_object_unref(window_child);
-    
-    // Create invisible placeholder to maintain paned structure
-    GtkWidget *placeholder = gtk_event_box_new();
-    gtk_widget_set_size_request(placeholder, -1, 60);
-    gtk_widget_set_opacity(placeholder, 0.0);  // Invisible
-    
-    // Replace ticker with placeholder in original parent
-    g_object_ref(ticker_fixed);
-    gtk_container_remove(GTK_CONTAINER(old_parent), ticker_fixed);
-    
-    // Add placeholder where ticker was
-    if (GTK_IS_PANED(old_parent)) {
-        gtk_paned_pack2(GTK_PANED(old_parent), placeholder, FALSE, FALSE);
-    } else if (GTK_IS_CONTAINER(old_parent)) {
-        gtk_container_add(GTK_CONTAINER(old_parent), placeholder);
+static void compositor_draw_text(cairo_t *cr, PangoLayout *layout,
+                                 const GdkRectangle *r, int x, const char *hex)
+{
+    int tw, th;
+    pango_layout_get_pixel_size(layout, &tw, &th);
+    if (x == G_MININT)                       // centred text
+        x = r->x + (r->width - tw) / 2;
+
+    cairo_save(cr);
+    cairo_rectangle(cr, r->x, r->y, r->width, r->height);
+    cairo_clip(cr);
+    aurum_set_source_hex(cr, hex);
+    cairo_move_to(cr, x, r->y + (r->height - th) / 2);
+    pango_cairo_show_layout(cr, layout);
+    cairo_restore(cr);
+}
+
+static gboolean compositor_draw(GtkWidget *widget, cairo_t *cr, gpointer user_data)
+{
+    GdkRectangle clip;
+    if (!gdk_cairo_get_clip_rectangle(cr, &clip))
+        return TRUE;
+
+    if (overlay_visible()) {
+        overlay_draw(cr, comp.layout.width, comp.layout.height);
+        trace_overlay = active_overlay;
+        return TRUE;
     }
-    
-    gtk_widget_show(placeholder);
-    
-    // Create eventbox wrapper for ticker overlay (for clipping)
-    GtkWidget *ticker_box = gtk_event_box_new();
-    gtk_widget_set_valign(ticker_box, GTK_ALIGN_END);  // Bottom of screen
-    gtk_widget_set_halign(ticker_box, GTK_ALIGN_FILL);  // Full width
-    gtk_widget_set_size_request(ticker_box, -1, 60);
-    
-    // Add ticker to overlay box
-    gtk_container_add(GTK_CONTAINER(ticker_box), ticker_fixed);
-    g_object_unref(ticker_fixed);
-    
-    // Add ticker overlay to main overlay
-    gtk_overlay_add_overlay(GTK_OVERLAY(overlay), ticker_box);
-    gtk_overlay_set_overlay_pass_through(GTK_OVERLAY(overlay), ticker_box, TRUE);
-    
-    // Put overlay in window
-    gtk_container_add(GTK_CONTAINER(window), overlay);
-    
-    gtk_widget_show_all(overlay);
+    trace_overlay = OVERLAY_NONE;
+
+    // Background for label/ticker areas; tiles are opaque and paint over it
+    aurum_set_source_hex(cr, AURUM_SCREEN_BG_HEX);
+    cairo_paint(cr);
+
+    if (gdk_rectangle_intersect(&clip, &comp.layout.top, NULL) && comp.top_layout)
+        compositor_draw_text(cr, comp.top_layout, &comp.layout.top, G_MININT, "#8B0000");
+
+    const char *tokens[SLOT_COUNT] = { current_token, previous_token, preceding_token };
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        const GdkRectangle *r = &comp.layout.tile[slot];
+        if (!gdk_rectangle_intersect(&clip, r, NULL))
+            continue;
+
+        // Not rendered yet: keep the previous tile up until the worker is done
+        gboolean show = (slot == SLOT_CURRENT) ? number_visible : TRUE;
+        cairo_surface_t *tile = tile_cache_peek(slot, r->width, r->height,
+                                                tokens[slot], show);
+        if (!tile) {
+            tiles_request_missing();
+            tile = tile_shown[slot];
+            if (!tile)
+                continue;
+        } else {
+            if (tile != tile_shown[slot]) {
+                if (tile_shown[slot]) cairo_surface_destroy(tile_shown[slot]);
+                tile_shown[slot] = cairo_surface_reference(tile);
+            }
+            if (slot == SLOT_CURRENT)
+                trace_paint_token(tokens[slot], show);
+        }
+
+        cairo_save(cr);
+        cairo_rectangle(cr, r->x, r->y, r->width, r->height);
+        cairo_clip(cr);
+        cairo_set_source_surface(cr, tile, r->x, r->y);
+        cairo_paint(cr);
+        cairo_restore(cr);
+    }
+
+    if (ticker_visible && ticker_strip &&
+        gdk_rectangle_intersect(&clip, &comp.layout.ticker_band, NULL))
+        ticker_draw(cr);
+
+    return TRUE;
 }
+
+static gboolean refresh_images_on_ui(gpointer user_data) {
+    // Tiles are resolved from the cache inside compositor_draw
+    for (int slot = 0; slot < SLOT_COUNT; slot++)
+        compositor_damage_slot(slot);
+    return FALSE;
+}
+
+static void load_layout_ratio(const char *key, double *ratio)
+{
+    char *val = read_config_value(config_path, key);
+    if (!val) return;
+
+    double r = g_ascii_strtod(val, NULL);
+    if (r > 0.05 && r < 0.95)
+        *ratio = r;
+    else
+        g_printerr("Ignoring %s=%s (expected 0.05..0.95)\n", key, val);
+    free(val);
+}
+
 // ===========================================================
 //                        TOKEN LOGIC
 // ===========================================================
@@ -677,274 +1666,519 @@ static void shift_tokens(const char *new_token) {
     strncpy(current_token, new_token, sizeof(current_token));
 }
 
-static gboolean update_ui_from_serial(gpointer user_data) {
-    // Refresh token images if they're visible
-    if (gtk_widget_get_visible(current_image)) {
-        g_idle_add(refresh_images_on_ui, NULL);
+// ===================== FRAME-COALESCED UI UPDATES =====================
+/*
+ * State changes (tokens, number_visible) only mark the UI stale. Once per
+ * frame the current state is compared with what was last presented and
+ * only the slots that differ are invalidated, so a 90-token history
+ * replay costs at most one render of each changed tile.
+ */
+static char presented_token[SLOT_COUNT][32] = { "--", "--", "--" };
+static gboolean presented_visible = TRUE;
+static guint ui_update_tick_id = 0;
+
+static void ui_flush_updates(void)
+{
+    const char *tokens[SLOT_COUNT] = { current_token, previous_token, preceding_token };
+
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        gboolean changed = strcmp(presented_token[slot], tokens[slot]) != 0;
+        if (slot == SLOT_CURRENT && presented_visible != number_visible)
+            changed = TRUE;
+        if (!changed)
+            continue;
+
+        g_strlcpy(presented_token[slot], tokens[slot], sizeof(presented_token[slot]));
+        compositor_damage_slot(slot);
     }
-    return FALSE;
+    presented_visible = number_visible;
+}
+
+static gboolean ui_update_tick(GtkWidget *widget, GdkFrameClock *clock,
+                               gpointer user_data)
+{
+    ui_update_tick_id = 0;
+    ui_flush_updates();
+    return G_SOURCE_REMOVE;
+}
+
+static void ui_schedule_update(void)
+{
+    if (ui_update_tick_id == 0 && compositor)
+        ui_update_tick_id = gtk_widget_add_tick_callback(compositor,
+                                ui_update_tick, NULL, NULL);
 }
 
 static gboolean hide_ticker_cb(gpointer data)
 {
-    gtk_widget_set_opacity(ticker_label, 0.0);
+    ticker_visible = FALSE;
+    compositor_damage(&comp.layout.ticker);
     return G_SOURCE_REMOVE;
 }
 
 static gboolean show_ticker_cb(gpointer data)
 {
-    gtk_widget_set_opacity(ticker_label, 1.0);
+    ticker_visible = TRUE;
+    compositor_damage(&comp.layout.ticker);
+    ticker_start();
     return G_SOURCE_REMOVE;
 }
 
-static void mpv_load_gif(const char *gif)
+// ===================== MPV IPC =====================
+// One persistent connection to mpv's JSON IPC socket, serviced from the
+// main loop: an fd watch while connected, and a one-shot timer at the
+// client's next deadline (reconnect or request timeout), so nothing
+// wakes up while mpv is simply not there.
+static AurumMpv mpv_ipc;
+static guint mpv_watch_id = 0;
+static int mpv_watch_fd = -1;
+static GIOCondition mpv_watch_cond = 0;
+static guint mpv_tick_id = 0;
+static int64_t mpv_tick_due_us = -1;
+
+static void mpv_ipc_sync(void);
+
+static void mpv_ipc_reply(unsigned id, const char *name, AurumMpvStatus status,
+                          int64_t rtt_us, const char *line, void *user)
 {
-    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
-    if (fd < 0)
+    switch (status) {
+    case AURUM_MPV_REPLY_OK:
+        g_print("mpv %s #%u: %.1f ms\n", name, id, rtt_us / 1000.0);
+        break;
+    case AURUM_MPV_REPLY_ERROR:
+        g_printerr("mpv %s #%u failed: %s\n", name, id, line);
+        break;
+    case AURUM_MPV_REPLY_TIMEOUT:
+        g_printerr("mpv %s #%u: no reply after %.1f ms\n", name, id, rtt_us / 1000.0);
+        break;
+    case AURUM_MPV_REPLY_DISCONNECTED:
+        g_printerr("mpv %s #%u: connection lost\n", name, id);
+        break;
+    default:
+        break;
+    }
+}
+
+static gboolean mpv_ipc_io_cb(gint fd, GIOCondition cond, gpointer data)
+{
+    guint self = mpv_watch_id;
+
+    aurum_mpv_handle(&mpv_ipc, (cond & (G_IO_IN | G_IO_HUP | G_IO_ERR)) != 0,
+                     (cond & G_IO_OUT) != 0, aurum_monotonic_us());
+    mpv_ipc_sync();
+    return mpv_watch_id == self ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+static gboolean mpv_ipc_tick_cb(gpointer data)
+{
+    mpv_tick_id = 0;
+    mpv_tick_due_us = -1;
+    aurum_mpv_tick(&mpv_ipc, aurum_monotonic_us());
+    mpv_ipc_sync();
+    return G_SOURCE_REMOVE;
+}
+
+// Match the fd watch and the timer to the client's current state
+static void mpv_ipc_sync(void)
+{
+    int fd = aurum_mpv_fd(&mpv_ipc);
+    GIOCondition cond = G_IO_IN;
+
+    if (aurum_mpv_wants_write(&mpv_ipc))
+        cond |= G_IO_OUT;
+
+    if (fd != mpv_watch_fd || cond != mpv_watch_cond) {
+        if (mpv_watch_id)
+            g_source_remove(mpv_watch_id);
+        mpv_watch_id = fd >= 0 ? g_unix_fd_add(fd, cond, mpv_ipc_io_cb, NULL) : 0;
+        mpv_watch_fd = fd;
+        mpv_watch_cond = cond;
+    }
+
+    int64_t due = aurum_mpv_next_deadline(&mpv_ipc);
+    if (due == mpv_tick_due_us)
         return;
+    if (mpv_tick_id)
+        g_source_remove(mpv_tick_id);
+    mpv_tick_id = 0;
+    mpv_tick_due_us = due;
+    if (due >= 0) {
+        int64_t wait_us = due - aurum_monotonic_us();
+        guint ms = wait_us > 0 ? (guint)((wait_us + 999) / 1000) : 0;
+        mpv_tick_id = g_timeout_add(ms, mpv_ipc_tick_cb, NULL);
+    }
+}
 
-    struct sockaddr_un addr = {0};
-    addr.sun_family = AF_UNIX;
-    strcpy(addr.sun_path, "/tmp/mpv.sock");
+// Replace whatever mpv is playing; both commands go out in one write
+static void mpv_load_gif(const char *gif)
+{
+    const char *clear[] = { "playlist-clear", NULL };
+    const char *load[]  = { "loadfile", gif, "replace", NULL };
+    int64_t now = aurum_monotonic_us();
+
+    if (!aurum_mpv_command(&mpv_ipc, clear, now) ||
+        !aurum_mpv_command(&mpv_ipc, load, now))
+        g_printerr("mpv command queue full, dropped %s\n", gif);
+    mpv_ipc_sync();
+}
 
-    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
-        char cmd[256];
-        snprintf(cmd, sizeof(cmd),
-                 "loadfile %s replace\n", gif);
-        write(fd, cmd, strlen(cmd));
+// ===========================================================
+//                SERIAL EVENT HANDLERS
+// ===========================================================
+/*
+ * FORMAT (tty5 dialect, see aurum_protocol.c for the full table):
+ * :01 1 <token>
+ * :00 3 6A  → GAME OVER (tty2)
+ * :00 3 7A  → CONGRATS (tty4)
+ * :00 3 7B  → BACK TO TTY1
+ * :00 3 5A  → HIDE TICKER
+ * :00 3 5B  → SHOW TICKER
+ * $S cur prev pre count n1..n  → FULL STATE SNAPSHOT (both dialects)
+ *
+ * TX: "snap" once at start-up asks the controller for a snapshot,
+ *     then "hdmi" every second as a heartbeat.
+ */
+static AurumParser serial_parser;
+
+// AURUM_RECORD=<path>: every received line, timed, for aurum_replay.
+// Fed only by the serial reader thread.
+static AurumRecorder serial_recorder = { .fd = -1 };
+
+/* Return from ANY overlay */
+static void return_from_overlay(void)
+{
+    overlay_hide();
+}
+
+/* ==================================================
+ * TOKEN UPDATE WITH BULK DETECTION
+ * ================================================== */
+static void on_serial_token(const char *token, gint64 arrival_us)
+{
+    /* BULK TOKEN DETECTION (uses arrival time, not drain time) */
+    long elapsed_ms = 0;
+    if (last_token_us != 0)
+        elapsed_ms = (long)((arrival_us - last_token_us) / 1000);
+
+    gboolean is_bulk_arrival = (elapsed_ms > 0 && 
+                               elapsed_ms < BULK_TOKEN_THRESHOLD_MS);
+
+    // A history replay keeps "Please wait" up and playing; anything else
+    // brings the token screen back
+    if (!(is_bulk_arrival && active_overlay == OVERLAY_PLEASE_WAIT))
+        return_from_overlay();
+
+    shift_tokens(token);
+
+    int n = token_cache_key(token, TRUE);
+    if (n >= 1 && n <= AURUM_NUMBER_MAX && !aurum_drawn_test(drawn_numbers, n)) {
+        aurum_drawn_set(drawn_numbers, n);
+        drawn_count++;
     }
 
-    close(fd);
+    last_token_us = arrival_us;
+    
+    if (!first_token_received) {
+        // First token ever - check if more coming
+        first_token_received = TRUE;
+        
+        if (is_bulk_arrival) {
+            // Start of bulk load (startup) - show "Please wait"
+            bulk_loading = TRUE;
+            number_visible = FALSE;  // Hide numbers during bulk
+            show_please_wait();
+        } else {
+            // Single first token on startup - flash it
+            bulk_loading = FALSE;
+            number_visible = TRUE;
+            first_ever_token = FALSE;  // Mark that we've shown first token
+            restart_flash();
+        }
+    } else {
+        if (is_bulk_arrival) {
+            // Continue bulk loading
+            bulk_loading = TRUE;
+            number_visible = FALSE;
+            
+            // Show "Please wait" if not already up
+            show_please_wait();
+            
+            // Finish bulk loading after 4 seconds of no tokens
+            anim_start(&bulk_finish_anim,
+                       g_get_monotonic_time() + BULK_FINISH_DELAY_MS * 1000);
+        } else {
+            // Single token (normal operation)
+            if (bulk_loading) {
+                // Just finished bulk loading - simply show tokens without flash
+                anim_stop(&bulk_finish_anim);
+                finish_bulk_loading();
+            } else {
+                // Regular single token - flash it
+                number_visible = TRUE;
+                restart_flash();
+            }
+        }
+    }
+    
+    ui_schedule_update();
+}
+
+/* "$N cur prev pre" (STM dialect): set all three slots at once */
+static void on_serial_slots(const AurumEvent *ev)
+{
+    return_from_overlay();
+
+    g_strlcpy(current_token,   ev->tokens[0], sizeof(current_token));
+    g_strlcpy(previous_token,  ev->tokens[1], sizeof(previous_token));
+    g_strlcpy(preceding_token, ev->tokens[2], sizeof(preceding_token));
+
+    ui_schedule_update();
+}
+
+/* ==================================================
+ * STATE SNAPSHOT
+ * "$S cur prev pre count n1..n" carries the whole game state in one
+ * line. It replaces timing-based bulk detection: the kiosk applies it
+ * atomically and renders once, with no "Please wait" hold-off.
+ * ================================================== */
+static void on_serial_snapshot(const AurumEvent *ev)
+{
+    anim_stop(&bulk_finish_anim);
+    anim_stop(&flash_anim);
+
+    g_strlcpy(current_token,   ev->tokens[0], sizeof(current_token));
+    g_strlcpy(previous_token,  ev->tokens[1], sizeof(previous_token));
+    g_strlcpy(preceding_token, ev->tokens[2], sizeof(preceding_token));
+    drawn_numbers[0] = ev->drawn[0];
+    drawn_numbers[1] = ev->drawn[1];
+    drawn_count = ev->ndrawn;
+
+    // Next token is a normal live draw: flash it, never treat it as bulk
+    first_token_received = TRUE;
+    first_ever_token = FALSE;
+    bulk_loading = FALSE;
+    last_token_us = 0;
+    number_visible = TRUE;
+
+    g_print("Snapshot applied: %d drawn, current %s\n", drawn_count, current_token);
+
+    return_from_overlay();
+    ui_schedule_update();
+}
+
+/* ==================================================
+ * CONTROL COMMANDS
+ * ================================================== */
+static void on_serial_control(AurumControl ctl)
+{
+    switch (ctl) {
+
+    /* ---------- GAME OVER ---------- */
+    case AURUM_CTL_GAME_OVER:
+        clear_tokens();
+        drawn_numbers[0] = drawn_numbers[1] = 0;
+        drawn_count = 0;
+        first_token_received = FALSE;  // Reset state
+        bulk_loading = FALSE;
+        first_ever_token = TRUE;  // Reset for next game
+
+        ui_schedule_update();
+        overlay_show(OVERLAY_GAME_OVER);
+        break;
+
+    /* ---------- CONGRATULATIONS ---------- */
+    case AURUM_CTL_CONGRATS:
+        overlay_show(OVERLAY_CONGRATS);
+        break;
+
+    /* ---------- EXIT OVERLAY ---------- */
+    case AURUM_CTL_EXIT_OVERLAY:
+    case AURUM_CTL_MAIN_SCREEN:
+    case AURUM_CTL_GAME_START:
+        return_from_overlay();
+        break;
+
+    /* ---------- PLEASE WAIT ---------- */
+    case AURUM_CTL_ROLLING:
+    case AURUM_CTL_PLEASE_WAIT:
+        show_please_wait();
+        break;
+
+    /* ---------- HIDE TICKER ---------- */
+    case AURUM_CTL_TICKER_HIDE:
+        hide_ticker_cb(NULL);
+        break;
+
+    /* ---------- SHOW TICKER ---------- */
+    case AURUM_CTL_TICKER_SHOW:
+        show_ticker_cb(NULL);
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Runs on the GTK main loop, one call per queued event
+static void apply_serial_event(const AurumEvent *ev, gint64 arrival_us)
+{
+    switch (ev->type) {
+    case AURUM_EV_TOKEN:
+    case AURUM_EV_BARE_TOKEN:
+        on_serial_token(ev->tokens[0], arrival_us);
+        break;
+    case AURUM_EV_SLOTS:
+        on_serial_slots(ev);
+        break;
+    case AURUM_EV_SNAPSHOT:
+        on_serial_snapshot(ev);
+        break;
+    case AURUM_EV_CONTROL:
+        on_serial_control(ev->control);
+        break;
+    default:
+        break;
+    }
+}
+
+// ===========================================================
+//          SERIAL THREAD -> MAIN LOOP EVENT QUEUE
+// ===========================================================
+/*
+ * The serial thread only parses and pushes events into an SPSC ring.
+ * It wakes the main loop through an eventfd, at most once per batch.
+ * The main loop drains the whole ring in one frame-clock tick, so all
+ * token/flag state is owned by the GTK thread.
+ */
+#define SERIAL_BURST_REPORT 8   // log queue depth for batches this large
+
+static AurumQueue serial_queue;
+static int serial_wake_fd = -1;
+static atomic_int serial_wake_pending;
+static guint serial_drain_tick_id = 0;
+
+// Producer: serial reader thread
+static void queue_serial_event(const AurumEvent *ev, void *user)
+{
+    gint64 arrival_us = aurum_monotonic_us();
+
+    // Ring full: back off and let the UART buffer absorb the burst
+    if (!aurum_queue_push(&serial_queue, ev, arrival_us)) {
+        aurum_queue_note_full(&serial_queue);
+        do
+            usleep(1000);
+        while (!aurum_queue_push(&serial_queue, ev, arrival_us));
+    }
+
+    if (!atomic_exchange(&serial_wake_pending, 1)) {
+        uint64_t one = 1;
+        if (write(serial_wake_fd, &one, sizeof(one)) < 0)
+            perror("serial wake");
+    }
+}
+
+// Consumer: drains everything queued so far in one batch
+static void drain_serial_queue(void)
+{
+    AurumQueuedEvent qe;
+    unsigned batch = 0;
+
+    // Clear before draining: a push after this point wakes us again
+    atomic_store(&serial_wake_pending, 0);
+
+    while (aurum_queue_pop(&serial_queue, &qe)) {
+        apply_serial_event(&qe.ev, qe.arrival_us);
+        batch++;
+    }
+
+    // Already inside this frame's tick: invalidate changed slots now
+    if (batch > 0 && ui_update_tick_id != 0) {
+        gtk_widget_remove_tick_callback(compositor, ui_update_tick_id);
+        ui_update_tick_id = 0;
+        ui_flush_updates();
+    }
+
+    if (batch >= SERIAL_BURST_REPORT) {
+        g_print("Serial burst: %u events in one frame "
+                "(queue high-water %u/%d, full stalls %lu)\n",
+                batch, aurum_queue_take_high_water(&serial_queue),
+                AURUM_QUEUE_CAPACITY,
+                (unsigned long)atomic_load(&serial_queue.full_stalls));
+    }
+}
+
+static gboolean serial_drain_tick(GtkWidget *widget, GdkFrameClock *clock,
+                                  gpointer user_data)
+{
+    serial_drain_tick_id = 0;
+    drain_serial_queue();
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean serial_wake_cb(gint fd, GIOCondition condition, gpointer user_data)
+{
+    uint64_t count;
+    if (read(fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        perror("serial wake read");
+
+    // Drain on the next frame; if nothing is being painted, drain now
+    if (!gtk_widget_get_mapped(compositor)) {
+        drain_serial_queue();
+    } else if (serial_drain_tick_id == 0) {
+        serial_drain_tick_id = gtk_widget_add_tick_callback(compositor,
+                                   serial_drain_tick, NULL, NULL);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+// AURUM_PROTOCOL=tty5 (default) | stm | both
+static unsigned serial_dialects_from_config(void)
+{
+    unsigned dialects = AURUM_DIALECT_TTY5;
+    char *val = read_config_value(config_path, "AURUM_PROTOCOL");
+    if (!val) return dialects;
+
+    if (strcmp(val, "stm") == 0)
+        dialects = AURUM_DIALECT_STM;
+    else if (strcmp(val, "both") == 0)
+        dialects = AURUM_DIALECT_TTY5 | AURUM_DIALECT_STM;
+    else if (strcmp(val, "tty5") != 0)
+        g_printerr("Unknown AURUM_PROTOCOL=%s, using tty5\n", val);
+
+    free(val);
+    return dialects;
 }
 
 // ===========================================================
 //                SERIAL READER THREAD (MAIN LOGIC)
+// Sleeps in poll() until the UART has bytes, so a line is handled the
+// moment it arrives and the thread never wakes while the line is idle.
 static void *serial_reader_thread(void *arg)
 {
-    char buf[256];
-    size_t pos = 0;
     char rbuf[64];
+    struct pollfd pfd = { .fd = serial_fd, .events = POLLIN };
 
     while (1) {
 
+        if (poll(&pfd, 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("serial poll");
+            break;
+        }
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            g_printerr("Serial port closed or in error (revents=0x%x)\n", pfd.revents);
+            break;
+        }
+
         int n = read(serial_fd, rbuf, sizeof(rbuf));
 
         if (n > 0) {
-
-            for (int i = 0; i < n; i++) {
-
-                char c = rbuf[i];
-
-                if (c == '\r' || c == '\n') {
-
-                    if (pos == 0)
-                        continue;
-
-                    buf[pos] = '\0';
-                    pos = 0;
-
-                    char *p = buf;
-                    while (*p == ' ') p++;
-
-                    char *save = NULL;
-                    char *f0 = strtok_r(p, " ", &save);
-                    char *f1 = strtok_r(NULL, " ", &save);
-                    char *f2 = strtok_r(NULL, " ", &save);
-
-                    /*
-                     * FORMAT:
-                     * :01 1 <token>
-                     * :00 3 6A  → GAME OVER (tty2)
-                     * :00 3 7A  → CONGRATS (tty4)
-                     * :00 3 7B  → BACK TO TTY1
-                     * :00 3 5A  → HIDE TICKER
-                     * :00 3 5B  → SHOW TICKER
-                     */
-
-                    /* ==================================================
-                     * TOKEN UPDATE WITH BULK DETECTION
-                     * ================================================== */
-                    if (f0 && strcmp(f0, ":01") == 0 &&
-                        f1 && strcmp(f1, "1") == 0 &&
-                        f2)
-                    {
-                        /* Return from ANY overlay VT */
-                        if (tty2_active || tty4_active || tty5_active) {
-                            system("sudo chvt 1");
-                            usleep(150000);
-                            system("sudo chvt 1");
-                            tty2_active = FALSE;
-                            tty4_active = FALSE;
-                            tty5_active = FALSE;
-                        }
-
-                        shift_tokens(f2);
-                        
-                        /* BULK TOKEN DETECTION */
-                        struct timespec now;
-                        clock_gettime(CLOCK_MONOTONIC, &now);
-
-                        long elapsed_ms = 0;
-                        if (last_token_time.tv_sec != 0) {
-                            elapsed_ms = (now.tv_sec - last_token_time.tv_sec) * 1000 +
-                                        (now.tv_nsec - last_token_time.tv_nsec) / 1000000;
-                        }
-
-                        gboolean is_bulk_arrival = (elapsed_ms > 0 && 
-                                                   elapsed_ms < BULK_TOKEN_THRESHOLD_MS);
-
-                        last_token_time = now;
-                        
-                        if (!first_token_received) {
-                            // First token ever - check if more coming
-                            first_token_received = TRUE;
-                            
-                            if (is_bulk_arrival) {
-                                // Start of bulk load (startup) - switch to TTY5
-                                bulk_loading = TRUE;
-                                number_visible = FALSE;  // Hide numbers during bulk
-                                show_please_wait_tty5();
-                            } else {
-                                // Single first token on startup - flash it
-                                bulk_loading = FALSE;
-                                number_visible = TRUE;
-                                first_ever_token = FALSE;  // Mark that we've shown first token
-                                
-                                
-                                // Trigger flash
-                                if (flash_timer_id > 0) {
-                                    g_source_remove(flash_timer_id);
-                                    flash_timer_id = 0;
-                                }
-                                if (flash_delay_id > 0)
-                                    g_source_remove(flash_delay_id);
-                                
-                                flash_delay_id = g_timeout_add(300, trigger_flash_after_delay, NULL);
-                            }
-                        } else {
-                            if (is_bulk_arrival) {
-                                // Continue bulk loading
-                                bulk_loading = TRUE;
-                                number_visible = FALSE;
-                                
-                                // Switch to TTY5 if not already there
-                                if (!tty5_active) {
-                                    show_please_wait_tty5();
-                                }
-                                
-                                // Reset finish timer
-                                if (bulk_finish_timer_id > 0) {
-                                    g_source_remove(bulk_finish_timer_id);
-                                }
-                                // Set timer to finish bulk loading after 4 seconds of no tokens
-                                bulk_finish_timer_id = g_timeout_add(BULK_FINISH_DELAY_MS, finish_bulk_loading, NULL);
-                            } else {
-                                // Single token (normal operation)
-                                if (bulk_loading) {
-                                    // Just finished bulk loading - simply show tokens without flash
-                                    if (bulk_finish_timer_id > 0) {
-                                        g_source_remove(bulk_finish_timer_id);
-                                        bulk_finish_timer_id = 0;
-                                    }
-                                    finish_bulk_loading(NULL);
-                                } else {
-                                    // Regular single token - flash it
-                                    number_visible = TRUE;
-                                    
-                                    
-                                    
-                                    if (flash_timer_id > 0) {
-                                        g_source_remove(flash_timer_id);
-                                        flash_timer_id = 0;
-                                    }
-                                    if (flash_delay_id > 0)
-                                        g_source_remove(flash_delay_id);
-                                    
-                                    flash_delay_id = g_timeout_add(300, trigger_flash_after_delay, NULL);
-                                }
-                            }
-                        }
-                        
-                        g_idle_add(update_ui_from_serial, NULL);
-                    }
-
-                    /* ==================================================
-                     * CONTROL COMMANDS
-                     * ================================================== */
-                    else if (f0 && strcmp(f0, ":00") == 0 &&
-                             f1 && strcmp(f1, "3") == 0 &&
-                             f2)
-                    {
-                        /* ---------- GAME OVER ---------- */
-                        if (strcmp(f2, "6A") == 0) {
-
-                            clear_tokens();
-                            first_token_received = FALSE;  // Reset state
-                            bulk_loading = FALSE;
-                            first_ever_token = TRUE;  // Reset for next game
-                            tty2_active = TRUE;
-                            tty4_active = FALSE;
-                            tty5_active = FALSE;
-
-                            g_idle_add(update_ui_from_serial, NULL);
-
-                            system(
-                                "printf \"playlist-clear\\n"
-                                "loadfile /home/pi/KIOSK/gameover.gif replace\\n\" "
-                                "| socat - /tmp/mpv.sock"
-                            );
-
-                            system("sudo chvt 2");
-                        }
-
-                        /* ---------- CONGRATULATIONS ---------- */
-                        else if (strcmp(f2, "7A") == 0) {
-
-                            tty4_active = TRUE;
-                            tty2_active = FALSE;
-                            tty5_active = FALSE;
-                            system(
-                                "printf \"playlist-clear\\n"
-                                "loadfile /home/pi/KIOSK/congratulations1.gif replace\\n\" "
-                                "| socat - /tmp/mpv.sock"
-                            );
-
-                            system("sudo chvt 4");
-                        }
-
-                        /* ---------- EXIT OVERLAY ---------- */
-                        else if (strcmp(f2, "7B") == 0) {
-
-                            if (tty2_active || tty4_active || tty5_active) {
-
-                                system("sudo chvt 1");
-                               usleep(150000);
-                               system("sudo chvt 1");
-
-                                tty2_active = FALSE;
-                                tty4_active = FALSE;
-                                tty5_active = FALSE;
-                            }
-                        }
-
-                        /* ---------- HIDE TICKER ---------- */
-                        else if (strcmp(f2, "5A") == 0) {
-                            g_idle_add(hide_ticker_cb, NULL);
-                        }
-
-                        /* ---------- SHOW TICKER ---------- */
-                        else if (strcmp(f2, "5B") == 0) {
-                            g_idle_add(show_ticker_cb, NULL);
-                        }
-                    }
-                }
-                else if (pos + 1 < sizeof(buf)) {
-                    buf[pos++] = c;
-                }
-            }
+            aurum_recorder_feed(&serial_recorder, rbuf, n, aurum_monotonic_us());
+            aurum_parser_feed(&serial_parser, rbuf, n);
         }
-        else {
-            usleep(20000);
+        else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            perror("serial read");
+            break;
         }
     }
 
@@ -955,6 +2189,10 @@ static void *serial_reader_thread(void *arg)
 //            SERIAL TX THREAD (every 1 second)
 // ===========================================================
 static void *serial_tx_thread(void *arg) {
+    // Controllers that support "$S" answer with one snapshot line instead
+    // of replaying history token by token
+    serial_send("snap\r\n");
+
     while (1) {
         serial_send("hdmi\r\n");
         usleep(1000000);
@@ -969,67 +2207,101 @@ int main(int argc, char *argv[]) {
 
     gtk_init(&argc, &argv);
     system("unclutter -idle 0.1 -root &");
+
+    if (getenv("AURUM_CONFIG"))
+        config_path = getenv("AURUM_CONFIG");
     
     // ---------------- Serial Setup ----------------
-    const char *serial_port = "/dev/serial0";
-
-    serial_fd = open(serial_port, O_RDWR | O_NOCTTY);
+    AurumSerialConfig serial_cfg;
+    aurum_serial_config_defaults(&serial_cfg);
+
+    char *cfg_port    = read_config_value(config_path, "AURUM_SERIAL_PORT");
+    char *cfg_baud    = read_config_value(config_path, "AURUM_SERIAL_BAUD");
+    char *cfg_framing = read_config_value(config_path, "AURUM_SERIAL_FRAMING");
+    if (aurum_serial_configure(&serial_cfg, cfg_port, cfg_baud, cfg_framing) < 0)
+        g_printerr("Bad serial settings in aurum.txt, keeping the rest at defaults\n");
+    free(cfg_port);
+    free(cfg_baud);
+    free(cfg_framing);
+
+    serial_fd = aurum_serial_open(&serial_cfg);
     if (serial_fd < 0) {
         perror("Failed to open serial port");
         return 1;
     }
 
-    struct termios options;
-    tcgetattr(serial_fd, &options);
-
-    cfsetispeed(&options, B9600);
-    cfsetospeed(&options, B9600);
-
-    options.c_cflag |= (CLOCAL | CREAD);
-    options.c_cflag &= ~CSIZE;
-    options.c_cflag |= CS8;
-    options.c_cflag &= ~PARENB;
-    options.c_cflag &= ~CSTOPB;
-    options.c_cflag &= ~CRTSCTS;
-
-    options.c_iflag = IGNPAR;
-    options.c_oflag = 0;
-    options.c_lflag = 0;
-
-    options.c_cc[VMIN]  = 0;
-    options.c_cc[VTIME] = 1;
-
-    tcsetattr(serial_fd, TCSANOW, &options);
+    // Reply that settled auto-baud; parsed once the event queue is up
+    char autobaud_reply[AURUM_LINE_MAX];
+    size_t autobaud_reply_len = 0;
+
+    if (serial_cfg.baud == AURUM_SERIAL_AUTO_BAUD) {
+        // Controller answers "snap" with a snapshot; the first rate whose
+        // reply parses wins
+        int baud = aurum_serial_autobaud(serial_fd, NULL, 0, "snap\r\n", 300,
+                                         serial_dialects_from_config(),
+                                         autobaud_reply, sizeof(autobaud_reply),
+                                         &autobaud_reply_len);
+        if (baud > 0)
+            g_print("Serial auto-baud: %d\n", baud);
+        else
+            g_printerr("Serial auto-baud failed, using %d\n", AURUM_SERIAL_DEFAULT_BAUD);
+    } else {
+        g_print("Serial %s at %d %d%c%d\n", serial_cfg.port, serial_cfg.baud,
+                serial_cfg.data_bits, serial_cfg.parity, serial_cfg.stop_bits);
+    }
 
 
     // ---------------- GTK Builder Setup ----------------
-    GtkBuilder *builder = gtk_builder_new_from_file("interface_paned_overlay.glade");
-
-    window        = GTK_WIDGET(gtk_builder_get_object(builder, "main"));
-    top_label     = GTK_WIDGET(gtk_builder_get_object(builder, "top_label"));
-    current_image = GTK_WIDGET(gtk_builder_get_object(builder, "current_image"));
-    previous_image = GTK_WIDGET(gtk_builder_get_object(builder, "previous_image"));
-    preceding_image = GTK_WIDGET(gtk_builder_get_object(builder, "preceding_image"));
+    GtkBuilder *builder = gtk_builder_new_from_file("interface_compositor.glade");
 
-    top_pane  = GTK_WIDGET(gtk_builder_get_object(builder, "top_pane"));
-    outermost = GTK_WIDGET(gtk_builder_get_object(builder, "outermost"));
-    outer     = GTK_WIDGET(gtk_builder_get_object(builder, "outer"));
-    inner     = GTK_WIDGET(gtk_builder_get_object(builder, "inner"));
+    window     = GTK_WIDGET(gtk_builder_get_object(builder, "main"));
+    compositor = GTK_WIDGET(gtk_builder_get_object(builder, "compositor"));
 
-    ticker_fixed = GTK_WIDGET(gtk_builder_get_object(builder, "ticker_fixed"));
-    ticker_label = GTK_WIDGET(gtk_builder_get_object(builder, "ticker_label"));
-    gif_area     = GTK_WIDGET(gtk_builder_get_object(builder, "gif_area"));
+    // ---------------- Layout Ratios ----------------
+    load_layout_ratio("AURUM_RATIO_TOP", &comp.ratios.top);
+    load_layout_ratio("AURUM_RATIO_TOKENS", &comp.ratios.tokens);
+    load_layout_ratio("AURUM_RATIO_CURRENT", &comp.ratios.current);
+    load_layout_ratio("AURUM_RATIO_PREVIOUS", &comp.ratios.previous);
 
-    isolate_ticker_with_overlay();
+    g_signal_connect(compositor, "size-allocate",
+                     G_CALLBACK(compositor_size_allocate), NULL);
+    g_signal_connect(compositor, "draw", G_CALLBACK(compositor_draw), NULL);
 
     // ---------------- Configurable Top Label ----------------
-    char *cfg_label = read_config_value("/boot/firmware/aurum.txt", "AURUM_TOP_LABEL");
+    char *cfg_label = read_config_value(config_path, "AURUM_TOP_LABEL");
     if (cfg_label) {
-        gtk_label_set_text(GTK_LABEL(top_label), cfg_label);
+        comp.top_text = g_strdup(cfg_label);
         g_print("Loaded top label from config: %s\n", cfg_label);
         free(cfg_label);
     }
 
+    // ---------------- Token Tile Cache Budget ----------------
+    char *cfg_cache = read_config_value(config_path, "AURUM_TILE_CACHE_MB");
+    if (cfg_cache) {
+        char *end;
+        long mb = strtol(cfg_cache, &end, 10);
+        if (end != cfg_cache && *end == '\0' && mb > 0 && (gsize)mb <= G_MAXSIZE >> 20)
+            tile_cache_budget = (gsize)mb * 1024 * 1024;
+        else
+            g_printerr("Bad AURUM_TILE_CACHE_MB=%s, using the default %d MB\n",
+                       cfg_cache, TILE_CACHE_DEFAULT_MB);
+        free(cfg_cache);
+    }
+    g_print("Tile cache budget: %zu MB\n", tile_cache_budget >> 20);
+
+    // ---------------- Surface Pixel Format ----------------
+    char *cfg_format = read_config_value(config_path, "AURUM_PIXEL_FORMAT");
+    if (cfg_format) {
+        if (!aurum_tile_parse_format(cfg_format, &pixel_format))
+            g_printerr("Unknown AURUM_PIXEL_FORMAT=%s, using %s\n", cfg_format,
+                       aurum_tile_format_name(pixel_format));
+        free(cfg_format);
+    }
+    g_print("Surface pixel format: %s\n", aurum_tile_format_name(pixel_format));
+
+    // Tiles are rendered off the main loop from the first frame on
+    render_worker_start();
+
     // ---------------- CSS Load ----------------
     GtkCssProvider *css = gtk_css_provider_new();
     gtk_css_provider_load_from_path(css, "style.css", NULL);
@@ -1040,13 +2312,6 @@ int main(int argc, char *argv[]) {
     );
 
     gtk_widget_show_all(window);
-    
-    // CRITICAL: Hide widgets AFTER show_all, otherwise they get shown again
-    //gtk_widget_hide(current_image);
-    //gtk_widget_hide(previous_image);
-    //gtk_widget_hide(preceding_image);
-    //gtk_widget_hide(outermost);  // Hide entire token display area on startup
-    gtk_widget_hide(gif_area);   // Hide GIF area
 
     // ---------------- Fullscreen Window ----------------
     GdkScreen *screen = gdk_screen_get_default();
@@ -1056,13 +2321,87 @@ int main(int argc, char *argv[]) {
     gtk_window_fullscreen(GTK_WINDOW(window));
     gtk_window_set_decorated(GTK_WINDOW(window), FALSE);
 
-    // Apply pane ratios after layout stabilizes
-    g_timeout_add(200, set_paned_ratios, NULL);
+    char *cfg_trace = read_config_value(config_path, "AURUM_LATENCY_TRACE");
+    if (cfg_trace) {
+        trace_start(cfg_trace);
+        free(cfg_trace);
+    }
+
+    // ---------------- VT Switch Manager ----------------
+    if (aurum_vt_init(&vt_manager, NULL, NULL, vt_switch_done, NULL) < 0) {
+        g_printerr("Failed to start VT switch thread\n");
+        return 1;
+    }
 
-    // ---------------- Show "Please wait..." on TTY5 at startup ----------------
-    show_please_wait_tty5();
+    // ---------------- Overlays ----------------
+    aurum_mpv_init(&mpv_ipc, AURUM_MPV_SOCKET, mpv_ipc_reply, NULL);
+
+    char *cfg_gif_cache = read_config_value(config_path, "AURUM_GIF_CACHE_MB");
+    if (cfg_gif_cache) {
+        char *end;
+        long mb = strtol(cfg_gif_cache, &end, 10);
+        if (end != cfg_gif_cache && *end == '\0' && mb >= 0 &&
+            (gsize)mb <= G_MAXSIZE >> 20) {
+            overlay_cache_budget = (gsize)mb * 1024 * 1024;
+            g_print("Overlay frame cache budget: %ld MB\n", mb);
+        } else {
+            g_printerr("Bad AURUM_GIF_CACHE_MB=%s, using the default %d MB\n",
+                       cfg_gif_cache, OVERLAY_CACHE_DEFAULT_MB);
+        }
+        free(cfg_gif_cache);
+    }
+
+    char *cfg_overlay_dir = read_config_value(config_path, "AURUM_OVERLAY_DIR");
+    if (cfg_overlay_dir)
+        overlay_dir = cfg_overlay_dir;      // kept for the life of the process
+
+    char *cfg_overlay = read_config_value(config_path, "AURUM_OVERLAY_BACKEND");
+    if (cfg_overlay && strcmp(cfg_overlay, "vt") == 0)
+        overlay_backend = OVERLAY_BACKEND_VT;
+    free(cfg_overlay);
+
+    if (overlay_backend == OVERLAY_BACKEND_INPROCESS) {
+        overlay_load_all();
+        if (comp.layout.height > 0)    // already allocated: build the cache now
+            overlay_cache_resize(comp.layout.width, comp.layout.height);
+        g_print("Overlays: in-process\n");
+    } else {
+        mpv_ipc_sync();     // mpv screens: connect in the background
+        g_print("Overlays: mpv on tty2/tty4/tty5\n");
+    }
+
+    // ---------------- Show "Please wait..." at startup ----------------
+    show_please_wait();
 
     // ---------------- Start Background Threads ----------------
+    aurum_queue_init(&serial_queue);
+    serial_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (serial_wake_fd < 0) {
+        perror("eventfd");
+        return 1;
+    }
+    g_unix_fd_add(serial_wake_fd, G_IO_IN, serial_wake_cb, NULL);
+
+    aurum_parser_init(&serial_parser, serial_dialects_from_config(),
+                      queue_serial_event, NULL);
+
+    char *cfg_record = read_config_value(config_path, "AURUM_RECORD");
+    if (cfg_record) {
+        if (aurum_recorder_open(&serial_recorder, cfg_record,
+                                aurum_monotonic_us(), g_get_real_time()) == 0)
+            g_print("Recording serial traffic to %s\n", cfg_record);
+        else
+            g_printerr("Cannot record serial traffic to %s: %s\n", cfg_record,
+                       g_strerror(errno));
+        free(cfg_record);
+    }
+
+    if (autobaud_reply_len > 0) {
+        aurum_recorder_feed(&serial_recorder, autobaud_reply, autobaud_reply_len,
+                            aurum_monotonic_us());
+        aurum_parser_feed(&serial_parser, autobaud_reply, autobaud_reply_len);
+    }
+
     pthread_t serial_thread;
     pthread_create(&serial_thread, NULL, serial_reader_thread, NULL);
     pthread_detach(serial_thread);
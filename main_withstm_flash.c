@@ -8,6 +8,9 @@
 #include <unistd.h>
 #include <termios.h>
 #include <signal.h>
+#include <errno.h>
+
+#include "aurum_protocol.h"
 
 // ===================== Widgets =====================
 GtkWidget *window; // main window is now global
@@ -382,6 +385,68 @@ static gboolean update_ui_from_serial(gpointer user_data) {
     return FALSE;
 }
 
+// ===================== Serial Event Handler =====================
+// Lines are parsed by aurum_protocol.c (STM dialect):
+//   ":00 1 12"           -> new draw, shift tokens
+//   ":00 3 ..."          -> start rolling (GIF overlay)
+//   "$N cur prev pre"    -> set all three tokens
+//   "$M T1/P1/G1/GS/C1"  -> screen changes
+//   anything else        -> plain token (old behaviour)
+static void handle_serial_event(const AurumEvent *ev, void *user)
+{
+    switch (ev->type) {
+    case AURUM_EV_TOKEN:
+        // :00 1 12 -> treat as a NEW draw: shift tokens (preserve history)
+        shift_tokens(ev->tokens[0]);
+        g_idle_add(update_ui_from_serial, NULL);
+        break;
+
+    case AURUM_EV_BARE_TOKEN:
+        g_idle_add(hide_overlay_gif, NULL);
+        shift_tokens(ev->tokens[0]);
+        g_idle_add(update_ui_from_serial, NULL);
+        break;
+
+    case AURUM_EV_SLOTS:
+    case AURUM_EV_SNAPSHOT:     // "$S": only the three visible slots are used here
+        g_strlcpy(current_token,   ev->tokens[0], sizeof(current_token));
+        g_strlcpy(previous_token,  ev->tokens[1], sizeof(previous_token));
+        g_strlcpy(preceding_token, ev->tokens[2], sizeof(preceding_token));
+        g_idle_add(update_ui_from_serial, NULL);
+        break;
+
+    case AURUM_EV_CONTROL:
+        switch (ev->control) {
+        case AURUM_CTL_ROLLING:
+            // ensure rolling.gif exists in working dir (or change name/path)
+            g_idle_add(show_fullscreen_gif, (gpointer)"rolling.gif");
+            break;
+        case AURUM_CTL_MAIN_SCREEN:   // Tambola main screen
+        case AURUM_CTL_PLEASE_WAIT:   // "please wait" UI state not implemented
+        case AURUM_CTL_GAME_START:
+            g_idle_add(hide_overlay_gif, NULL);
+            break;
+        case AURUM_CTL_GAME_OVER:
+            // Game over: show gameover gif, reset tokens
+            g_idle_add(show_fullscreen_gif, (gpointer)"gameover1.gif");
+            strncpy(current_token, "--", sizeof(current_token));
+            strncpy(previous_token, "--", sizeof(previous_token));
+            strncpy(preceding_token, "--", sizeof(preceding_token));
+            g_idle_add(update_ui_from_serial, NULL);
+            break;
+        case AURUM_CTL_CONGRATS:
+            g_idle_add(show_fullscreen_gif, (gpointer)"congratulations1.gif");
+            break;
+        default:
+            break;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
 // ===================== Serial Thread =====================
 // Replace your existing serial_reader_thread with this function:
 
@@ -416,120 +481,14 @@ static void *serial_reader_thread(void *arg) {
     tcsetattr(fd, TCSANOW, &options);
     tcflush(fd, TCIFLUSH);
 
-    #define LINEBUF_SIZE 1024
-    char linebuf[LINEBUF_SIZE];
-    size_t linepos = 0;
+    AurumParser parser;
+    aurum_parser_init(&parser, AURUM_DIALECT_STM, handle_serial_event, NULL);
     char rbuf[128];
 
     while (1) {
         int n = read(fd, rbuf, sizeof(rbuf));
         if (n > 0) {
-            for (int i = 0; i < n; ++i) {
-                char c = rbuf[i];
-
-                // treat CR or LF as end-of-line
-                if (c == '\r' || c == '\n') {
-                    if (linepos == 0) {
-                        // skip empty line
-                        continue;
-                    }
-
-                    // terminate current line
-                    linebuf[linepos] = '\0';
-
-                    // trim leading spaces
-                    char *p = linebuf;
-                    while (*p == ' ') p++;
-
-                    // Tokenize safely
-                    char *saveptr = NULL;
-                    char *field0 = strtok_r(p, " ", &saveptr); // e.g. ":00" or "$N" or arbitrary token
-                    char *field1 = strtok_r(NULL, " ", &saveptr); // e.g. "1" or "T1"
-                    char *field2 = strtok_r(NULL, " ", &saveptr); // param or number
-
-                    // 1) : commands e.g. ":00 1 12" or ":00 3 6A"
-                    if (field0 && field0[0] == ':') {
-                        if (field1 && field2) {
-                            if (strcmp(field1, "1") == 0) {
-                                 // :00 1 12 -> treat as a NEW draw: shift tokens (preserve history)
-                                    shift_tokens(field2);                    // previous <- current, preceding <- previous, current <- field2
-                                    g_idle_add(update_ui_from_serial, NULL);
-                            } else if (strcmp(field1, "3") == 0) {
-                                // initialise displays (start rolling) -> show a rolling GIF overlay
-                                // ensure rolling.gif exists in working dir (or change name/path)
-                                g_idle_add(show_fullscreen_gif, (gpointer)"rolling.gif");
-                            }
-                        }
-                    }
-                    // 2) $N current previous preceding
-                    else if (field0 && strcmp(field0, "$N") == 0) {
-                        // parse three fields (if present) and set tokens
-                        char tmp_cur[32] = "--", tmp_prev[32] = "--", tmp_pre[32] = "--";
-                        if (field1) strncpy(tmp_cur, field1, sizeof(tmp_cur)-1);
-                        char *f3 = strtok_r(NULL, " ", &saveptr);
-                        if (f3) strncpy(tmp_prev, f3, sizeof(tmp_prev)-1);
-                        char *f4 = strtok_r(NULL, " ", &saveptr);
-                        if (f4) strncpy(tmp_pre, f4, sizeof(tmp_pre)-1);
-
-                        strncpy(current_token, tmp_cur, sizeof(current_token)-1);
-                        current_token[sizeof(current_token)-1] = '\0';
-                        strncpy(previous_token, tmp_prev, sizeof(previous_token)-1);
-                        previous_token[sizeof(previous_token)-1] = '\0';
-                        strncpy(preceding_token, tmp_pre, sizeof(preceding_token)-1);
-                        preceding_token[sizeof(preceding_token)-1] = '\0';
-
-                        g_idle_add(update_ui_from_serial, NULL);
-                    }
-                    // 3) $M messages: T1, P1, G1, GS, C1
-                    else if (field0 && strcmp(field0, "$M") == 0) {
-                        if (field1) {
-                            if (strcmp(field1, "T1") == 0) {
-                                // Tambola main screen
-                                // If you have a callback, call it; otherwise you can set top label or similar.
-                                // For now hide overlay and refresh UI main screen
-                                g_idle_add(hide_overlay_gif, NULL);
-                                // (If you have a dedicated function, call it here)
-                            } else if (strcmp(field1, "P1") == 0) {
-                                // Please wait
-                                g_idle_add(hide_overlay_gif, NULL);
-                                // optionally set a "please wait" UI state (not implemented)
-                            } else if (strcmp(field1, "G1") == 0) {
-                                // Game over: show gameover gif, reset tokens
-                                g_idle_add(show_fullscreen_gif, (gpointer)"gameover1.gif");
-                                strncpy(current_token, "--", sizeof(current_token));
-                                strncpy(previous_token, "--", sizeof(previous_token));
-                                strncpy(preceding_token, "--", sizeof(preceding_token));
-                                g_idle_add(update_ui_from_serial, NULL);
-                            } else if (strcmp(field1, "GS") == 0) {
-                                // Game starting
-                                g_idle_add(hide_overlay_gif, NULL);
-                            } else if (strcmp(field1, "C1") == 0) {
-                                // Congratulations
-                                g_idle_add(show_fullscreen_gif, (gpointer)"congratulations1.gif");
-                            }
-                        }
-                    }
-                    // 4) fallback — treat first token as plain token (old behavior)
-                    else if (field0) {
-                        g_idle_add(hide_overlay_gif, NULL);
-                        shift_tokens(field0);
-                        g_idle_add(update_ui_from_serial, NULL);
-                    }
-
-                    // reset line buffer
-                    linepos = 0;
-                    linebuf[0] = '\0';
-                } else {
-                    // normal character: append if space remains
-                    if (linepos + 1 < LINEBUF_SIZE) {
-                        linebuf[linepos++] = c;
-                    } else {
-                        // overflow: discard buffer
-                        linepos = 0;
-                        linebuf[0] = '\0';
-                    }
-                }
-            } // end for
+            aurum_parser_feed(&parser, rbuf, n);
         } else if (n == 0) {
             // no data available right now
             usleep(20000);
@@ -0,0 +1,426 @@
+// ==========================
+//  MPV IPC CLIENT TEST + FAKE MPV SERVER
+//
+//  gcc -O2 -pthread mpv_ipc_test.c aurum_mpv.c -o mpv_ipc_test
+//  ./mpv_ipc_test                     client tests against an in-process fake
+//  ./mpv_ipc_test serve [socket]      run the fake mpv on its own (default
+//                                     /tmp/mpv.sock) to try the kiosk without mpv
+//
+//  The fake answers every command with {"request_id":N,"error":"success"},
+//  emits a start-file event after loadfile, rejects the "fail" command and
+//  can drop the connection after a given number of commands.
+// ==========================
+
+#include "aurum_mpv.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===================== FAKE MPV SERVER =====================
+#define FAKE_CLIENTS 4
+
+typedef struct {
+    char path[108];
+    int listen_fd;
+    int stop_pipe[2];
+    unsigned long drop_after;   // close the client after this many commands (0 = never)
+    int verbose;
+    unsigned long commands;
+    pthread_t thread;
+} FakeMpv;
+
+typedef struct {
+    int fd;
+    char buf[4096];
+    size_t len;
+} FakeClient;
+
+static void fake_reply(FakeMpv *s, FakeClient *c, const char *line)
+{
+    char out[256];
+    const char *rid = strstr(line, "\"request_id\":");
+    unsigned long id = rid ? strtoul(rid + 13, NULL, 10) : 0;
+    int n;
+
+    if (s->verbose)
+        printf("fake mpv: %s\n", line);
+
+    if (strstr(line, "[\"fail\""))
+        n = snprintf(out, sizeof(out),
+                     "{\"request_id\":%lu,\"error\":\"invalid parameter\"}\n", id);
+    else
+        n = snprintf(out, sizeof(out),
+                     "{\"data\":null,\"request_id\":%lu,\"error\":\"success\"}\n", id);
+    if (strstr(line, "[\"loadfile\""))
+        n += snprintf(out + n, sizeof(out) - (size_t)n,
+                      "{\"event\":\"start-file\",\"playlist_entry_id\":1}\n");
+
+    send(c->fd, out, (size_t)n, MSG_NOSIGNAL);
+}
+
+static void fake_close_client(FakeClient *c)
+{
+    close(c->fd);
+    c->fd = -1;
+    c->len = 0;
+}
+
+static void fake_read(FakeMpv *s, FakeClient *c)
+{
+    ssize_t n = read(c->fd, c->buf + c->len, sizeof(c->buf) - 1 - c->len);
+    if (n <= 0) {
+        fake_close_client(c);
+        return;
+    }
+    c->len += (size_t)n;
+
+    char *start = c->buf, *nl;
+    while ((nl = memchr(start, '\n', c->len - (size_t)(start - c->buf))) != NULL) {
+        *nl = '\0';
+        s->commands++;
+        if (s->drop_after && s->commands % s->drop_after == 0) {
+            fake_close_client(c);   // mid-pipeline, no reply
+            return;
+        }
+        fake_reply(s, c, start);
+        start = nl + 1;
+    }
+    c->len -= (size_t)(start - c->buf);
+    memmove(c->buf, start, c->len);
+}
+
+static void *fake_mpv_thread(void *arg)
+{
+    FakeMpv *s = arg;
+    FakeClient clients[FAKE_CLIENTS];
+
+    for (int i = 0; i < FAKE_CLIENTS; i++)
+        clients[i].fd = -1;
+
+    for (;;) {
+        struct pollfd pfd[2 + FAKE_CLIENTS];
+        int map[2 + FAKE_CLIENTS];
+        int n = 0;
+
+        pfd[n].fd = s->stop_pipe[0]; pfd[n].events = POLLIN; map[n++] = -2;
+        pfd[n].fd = s->listen_fd;    pfd[n].events = POLLIN; map[n++] = -1;
+        for (int i = 0; i < FAKE_CLIENTS; i++) {
+            if (clients[i].fd < 0) continue;
+            pfd[n].fd = clients[i].fd; pfd[n].events = POLLIN; map[n++] = i;
+        }
+
+        if (poll(pfd, (nfds_t)n, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (pfd[0].revents)
+            break;
+
+        for (int k = 1; k < n; k++) {
+            if (!pfd[k].revents)
+                continue;
+            if (map[k] == -1) {
+                int fd = accept(s->listen_fd, NULL, NULL);
+                for (int i = 0; fd >= 0 && i < FAKE_CLIENTS; i++) {
+                    if (clients[i].fd < 0) {
+                        clients[i].fd = fd;
+                        clients[i].len = 0;
+                        fd = -1;
+                    }
+                }
+                if (fd >= 0) close(fd);
+            } else {
+                fake_read(s, &clients[map[k]]);
+            }
+        }
+    }
+
+    for (int i = 0; i < FAKE_CLIENTS; i++)
+        if (clients[i].fd >= 0)
+            close(clients[i].fd);
+    return NULL;
+}
+
+static int fake_mpv_start(FakeMpv *s, const char *path, unsigned long drop_after)
+{
+    struct sockaddr_un addr;
+
+    memset(s, 0, sizeof(*s));
+    snprintf(s->path, sizeof(s->path), "%s", path);
+    s->drop_after = drop_after;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    unlink(path);
+
+    s->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (s->listen_fd < 0 ||
+        bind(s->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(s->listen_fd, 8) < 0 ||
+        pipe(s->stop_pipe) < 0) {
+        perror("fake mpv");
+        return -1;
+    }
+    return pthread_create(&s->thread, NULL, fake_mpv_thread, s) == 0 ? 0 : -1;
+}
+
+static void fake_mpv_stop(FakeMpv *s)
+{
+    write(s->stop_pipe[1], "x", 1);
+    pthread_join(s->thread, NULL);
+    close(s->listen_fd);
+    close(s->stop_pipe[0]);
+    close(s->stop_pipe[1]);
+    unlink(s->path);
+}
+
+// ===================== CLIENT DRIVER =====================
+typedef struct {
+    unsigned long ok, error, timeout, dropped, events;
+} Tally;
+
+static void on_reply(unsigned id, const char *name, AurumMpvStatus st,
+                     int64_t rtt_us, const char *line, void *user)
+{
+    Tally *t = user;
+    (void)id; (void)name; (void)rtt_us; (void)line;
+
+    switch (st) {
+    case AURUM_MPV_REPLY_OK:           t->ok++;      break;
+    case AURUM_MPV_REPLY_ERROR:        t->error++;   break;
+    case AURUM_MPV_REPLY_TIMEOUT:      t->timeout++; break;
+    case AURUM_MPV_REPLY_DISCONNECTED: t->dropped++; break;
+    case AURUM_MPV_REPLY_EVENT:        t->events++;  break;
+    }
+}
+
+// One poll round, as the kiosk's main loop would do it
+static void pump(AurumMpv *m, int timeout_ms)
+{
+    int fd = aurum_mpv_fd(m);
+
+    if (fd >= 0) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (aurum_mpv_wants_write(m))
+            pfd.events |= POLLOUT;
+        if (poll(&pfd, 1, timeout_ms) > 0)
+            aurum_mpv_handle(m, (pfd.revents & (POLLIN | POLLHUP | POLLERR)) != 0,
+                             (pfd.revents & POLLOUT) != 0, now_us());
+    } else if (timeout_ms > 0) {
+        usleep((useconds_t)timeout_ms * 1000);
+    }
+    aurum_mpv_tick(m, now_us());
+}
+
+static int pump_until(AurumMpv *m, const Tally *t, unsigned long want, int64_t limit_us)
+{
+    int64_t end = now_us() + limit_us;
+    while (t->ok + t->error + t->timeout + t->dropped < want) {
+        if (now_us() > end)
+            return -1;
+        pump(m, 10);
+    }
+    return 0;
+}
+
+static void overlay_commands(AurumMpv *m, const char *gif)
+{
+    const char *clear[] = { "playlist-clear", NULL };
+    const char *load[]  = { "loadfile", gif, "replace", NULL };
+    aurum_mpv_command(m, clear, now_us());
+    aurum_mpv_command(m, load, now_us());
+}
+
+// Keep the in-flight window from filling during the bulk run
+static void wait_window(AurumMpv *m)
+{
+    while (m->ninflight > AURUM_MPV_MAX_INFLIGHT - 2)
+        pump(m, 10);
+}
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: " __VA_ARGS__); fputc('\n', stderr); return 1; } \
+} while (0)
+
+// ===================== SCENARIOS =====================
+static int test_pipeline(const char *path)
+{
+    enum { OVERLAYS = 2000 };
+    FakeMpv s;
+    AurumMpv m;
+    Tally t = { 0 };
+
+    CHECK(fake_mpv_start(&s, path, 0) == 0, "server");
+    aurum_mpv_init(&m, path, on_reply, &t);
+    aurum_mpv_tick(&m, now_us());
+    CHECK(aurum_mpv_fd(&m) >= 0, "connect");
+
+    int64_t t0 = now_us();
+    for (int i = 0; i < OVERLAYS; i++) {
+        wait_window(&m);
+        overlay_commands(&m, i & 1 ? "/home/pi/KIOSK/gameover.gif"
+                                   : "/home/pi/KIOSK/congratulations1.gif");
+    }
+    CHECK(pump_until(&m, &t, 2 * OVERLAYS, 5000000) == 0, "replies missing");
+    int64_t dt = now_us() - t0;
+
+    CHECK(t.ok == 2 * OVERLAYS && t.error == 0, "ok=%lu error=%lu", t.ok, t.error);
+    printf("pipeline: %d overlays (%lu commands) in %.1f ms, "
+           "rtt mean %.1f us max %.1f us, %lu events\n",
+           OVERLAYS, m.sent, dt / 1000.0,
+           (double)m.total_rtt_us / m.replies, (double)m.max_rtt_us, t.events);
+
+    // Old way: a fresh socket per command
+    int64_t o0 = now_us();
+    for (int i = 0; i < 2 * OVERLAYS; i++) {
+        struct sockaddr_un addr = { .sun_family = AF_UNIX };
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+            write(fd, "loadfile /home/pi/KIOSK/gameover.gif replace\n", 45);
+        close(fd);
+    }
+    printf("pipeline: connect-per-command took %.1f ms for the same count "
+           "(no replies read)\n", (now_us() - o0) / 1000.0);
+
+    // Rejected command is reported as an error, not a success
+    const char *bad[] = { "fail", NULL };
+    aurum_mpv_command(&m, bad, now_us());
+    CHECK(pump_until(&m, &t, 2 * OVERLAYS + 1, 1000000) == 0 && t.error == 1,
+          "error reply not seen");
+
+    aurum_mpv_close(&m);
+    fake_mpv_stop(&s);
+    return 0;
+}
+
+static int test_reconnect(const char *path)
+{
+    FakeMpv s;
+    AurumMpv m;
+    Tally t = { 0 };
+
+    CHECK(fake_mpv_start(&s, path, 5) == 0, "server");
+    aurum_mpv_init(&m, path, on_reply, &t);
+    aurum_mpv_tick(&m, now_us());
+
+    // Server hangs up on the 5th command: 4 replies, the rest dropped
+    for (int i = 0; i < 4; i++)
+        overlay_commands(&m, "/home/pi/KIOSK/gameover.gif");
+    CHECK(pump_until(&m, &t, 8, 1000000) == 0, "drop not reported");
+    CHECK(t.ok == 4 && t.dropped == 4, "ok=%lu dropped=%lu", t.ok, t.dropped);
+    CHECK(m.disconnects == 1, "disconnects=%lu", m.disconnects);
+
+    // Next command waits out the backoff, reconnects and goes through
+    int64_t r0 = now_us();
+    overlay_commands(&m, "/home/pi/KIOSK/congratulations1.gif");
+    CHECK(pump_until(&m, &t, 10, 2000000) == 0 && t.ok == 6,
+          "no reply after reconnect (ok=%lu)", t.ok);
+    printf("reconnect: drop reported, back in %.1f ms (backoff %d ms)\n",
+           (now_us() - r0) / 1000.0, AURUM_MPV_BACKOFF_MIN_US / 1000);
+
+    aurum_mpv_close(&m);
+    fake_mpv_stop(&s);
+    return 0;
+}
+
+static int test_late_server(const char *path)
+{
+    FakeMpv s;
+    AurumMpv m;
+    Tally t = { 0 };
+
+    unlink(path);
+    aurum_mpv_init(&m, path, on_reply, &t);
+
+    // mpv not up yet: commands queue, connects back off
+    overlay_commands(&m, "/home/pi/KIOSK/Please_wait.gif");
+    for (int i = 0; i < 30; i++)
+        pump(&m, 10);
+    CHECK(aurum_mpv_fd(&m) < 0 && t.ok == 0, "connected to nothing?");
+    CHECK(m.backoff_us > AURUM_MPV_BACKOFF_MIN_US, "no backoff");
+
+    CHECK(fake_mpv_start(&s, path, 0) == 0, "server");
+    CHECK(pump_until(&m, &t, 2, 3000000) == 0 && t.ok == 2,
+          "queued commands not delivered (ok=%lu)", t.ok);
+    CHECK(aurum_mpv_next_deadline(&m) == -1, "idle connection still wants a timer");
+    printf("late server: queued commands delivered after connect\n");
+
+    // Commands stuck behind a dead server expire instead of replaying late
+    aurum_mpv_close(&m);
+    fake_mpv_stop(&s);
+    aurum_mpv_init(&m, path, on_reply, &t);
+    overlay_commands(&m, "/home/pi/KIOSK/gameover.gif");
+    // The oldest request sets the deadline; both have expired by the last one's
+    int64_t expires = m.inflight[0].queued_us + AURUM_MPV_TIMEOUT_US + 1;
+    int64_t all_expired = m.inflight[m.ninflight - 1].queued_us + AURUM_MPV_TIMEOUT_US + 1;
+    aurum_mpv_tick(&m, now_us());
+    CHECK(aurum_mpv_fd(&m) < 0 && aurum_mpv_next_deadline(&m) == m.retry_at_us,
+          "disconnected: next deadline is not the reconnect");
+    m.retry_at_us = all_expired + 1000000;
+    CHECK(aurum_mpv_next_deadline(&m) == expires,
+          "next deadline %lld, wanted the request timeout %lld",
+          (long long)aurum_mpv_next_deadline(&m), (long long)expires);
+    aurum_mpv_tick(&m, all_expired);
+    CHECK(t.timeout == 2 && m.out_len == 0 && m.ninflight == 0,
+          "timeout=%lu out_len=%zu", t.timeout, m.out_len);
+    CHECK(aurum_mpv_next_deadline(&m) == m.retry_at_us, "no reconnect after timeouts");
+    printf("late server: stale commands timed out and discarded\n");
+    return 0;
+}
+
+// ===================== SERVE MODE =====================
+static volatile sig_atomic_t stop_serving;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_serving = 1;
+}
+
+static int serve(const char *path)
+{
+    FakeMpv s;
+
+    if (fake_mpv_start(&s, path, 0) < 0)
+        return 1;
+    s.verbose = 1;
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    printf("fake mpv listening on %s (Ctrl-C to stop)\n", path);
+    while (!stop_serving)
+        pause();
+    fake_mpv_stop(&s);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "serve") == 0)
+        return serve(argc >= 3 ? argv[2] : AURUM_MPV_SOCKET);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/mpv_ipc_test.%d.sock", (int)getpid());
+
+    if (test_pipeline(path) || test_reconnect(path) || test_late_server(path))
+        return 1;
+    printf("all mpv IPC tests passed\n");
+    return 0;
+}
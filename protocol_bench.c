@@ -0,0 +1,195 @@
+// ==========================
+//  PROTOCOL PARSER BENCHMARK + FUZZ HARNESS
+//
+//  gcc -O2 protocol_bench.c aurum_protocol.c -o protocol_bench
+//  ./protocol_bench bench [lines]      throughput vs. UART line rates
+//  ./protocol_bench fuzz  [iterations] random/mutated input, split-feed check
+//
+//  Build with -fsanitize=address,undefined for fuzzing runs, or with
+//  -DAURUM_LIBFUZZER -fsanitize=fuzzer (clang) to use libFuzzer instead.
+// ==========================
+
+#include "aurum_protocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *sample_lines[] = {
+    ":01 1 42\r\n",
+    ":01 1 7\r\n",
+    ":00 3 6A\r\n",
+    ":00 3 7A\r\n",
+    ":00 3 7B\r\n",
+    ":00 3 5A\r\n",
+    ":00 3 5B\r\n",
+    "$N 12 45 78\r\n",
+    "$M T1\r\n",
+    "$M G1\r\n",
+    ":02 1 90\r\n",
+    "hdmi-ack\r\n",
+    "$S 12 45 78 5 3 78 45 12 90\r\n",
+};
+#define NSAMPLES (sizeof(sample_lines) / sizeof(sample_lines[0]))
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ===================== EVENT RECORDING =====================
+typedef struct {
+    unsigned long count;
+    unsigned long hash;
+} EventLog;
+
+static void log_event(const AurumEvent *ev, void *user)
+{
+    EventLog *log = user;
+    unsigned long h = log->hash * 31 + ev->type * 7 + ev->control;
+
+    h = h * 131 + ev->drawn[0] + ev->drawn[1] * 3 + (unsigned long)ev->ndrawn;
+
+    if (ev->ntokens < 0 || ev->ntokens > 3) {
+        fprintf(stderr, "FAIL: ntokens=%d\n", ev->ntokens);
+        abort();
+    }
+    for (int t = 0; t < ev->ntokens; t++) {
+        if (memchr(ev->tokens[t], '\0', AURUM_TOKEN_MAX) == NULL) {
+            fprintf(stderr, "FAIL: unterminated token\n");
+            abort();
+        }
+        for (const char *c = ev->tokens[t]; *c; c++)
+            h = h * 131 + (unsigned char)*c;
+    }
+    log->hash = h;
+    log->count++;
+}
+
+// ===================== BENCHMARK =====================
+static int run_bench(unsigned long nlines)
+{
+    size_t cap = nlines * 16;
+    char *buf = malloc(cap);
+    size_t len = 0;
+
+    for (unsigned long i = 0; i < nlines; i++) {
+        const char *l = sample_lines[i % NSAMPLES];
+        size_t n = strlen(l);
+        memcpy(buf + len, l, n);
+        len += n;
+    }
+
+    static const size_t chunks[] = { 1, 8, 64, 4096 };
+
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        AurumParser p;
+        EventLog log = { 0, 0 };
+        aurum_parser_init(&p, AURUM_DIALECT_TTY5 | AURUM_DIALECT_STM, log_event, &log);
+
+        double t0 = now_sec();
+        for (size_t off = 0; off < len; off += chunks[c]) {
+            size_t n = len - off < chunks[c] ? len - off : chunks[c];
+            aurum_parser_feed(&p, buf + off, n);
+        }
+        double dt = now_sec() - t0;
+
+        double mbps = len / dt / 1e6;
+        // 10 bits per byte on an 8N1 UART
+        printf("chunk=%4zu  %8.1f MB/s  %10.0f lines/s  events=%lu  "
+               "x%.0f of 921600 baud\n",
+               chunks[c], mbps, p.lines / dt, log.count,
+               (len / dt) / (921600.0 / 10));
+    }
+
+    free(buf);
+    return 0;
+}
+
+// ===================== FUZZ =====================
+static void fuzz_one(const char *data, size_t n)
+{
+    AurumParser whole, split;
+    EventLog a = { 0, 0 }, b = { 0, 0 };
+
+    aurum_parser_init(&whole, AURUM_DIALECT_TTY5 | AURUM_DIALECT_STM, log_event, &a);
+    aurum_parser_init(&split, AURUM_DIALECT_TTY5 | AURUM_DIALECT_STM, log_event, &b);
+
+    aurum_parser_feed(&whole, data, n);
+
+    // Same bytes in random-sized chunks must produce identical events
+    size_t off = 0;
+    while (off < n) {
+        size_t k = 1 + (size_t)(rand() % 17);
+        if (k > n - off) k = n - off;
+        aurum_parser_feed(&split, data + off, k);
+        off += k;
+    }
+
+    if (a.count != b.count || a.hash != b.hash) {
+        fprintf(stderr, "FAIL: chunking changed the event stream\n");
+        abort();
+    }
+}
+
+#ifdef AURUM_LIBFUZZER
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz_one((const char *)data, size);
+    return 0;
+}
+#else
+static int run_fuzz(unsigned long iterations)
+{
+    static const char alphabet[] = ":$01356789ABGNMPSTC- \r\n";
+    char buf[2048];
+
+    srand(12345);
+    for (unsigned long it = 0; it < iterations; it++) {
+        size_t n = 0, target = (size_t)(rand() % sizeof(buf));
+
+        while (n < target) {
+            int mode = rand() % 4;
+            if (mode == 0) {
+                // Valid line, possibly truncated
+                const char *l = sample_lines[rand() % NSAMPLES];
+                size_t k = strlen(l);
+                if (rand() % 3 == 0) k = (size_t)(rand() % (k + 1));
+                if (k > target - n) k = target - n;
+                memcpy(buf + n, l, k);
+                n += k;
+            } else if (mode == 1) {
+                buf[n++] = alphabet[rand() % (sizeof(alphabet) - 1)];
+            } else if (mode == 2) {
+                buf[n++] = (char)(rand() & 0xff);
+            } else {
+                // Long field/line runs to hit the overflow paths
+                size_t k = (size_t)(rand() % 600);
+                char c = (rand() % 2) ? 'x' : ' ';
+                while (k-- && n < target) {
+                    buf[n++] = c;
+                    if (c == ' ') c = 'y'; else if (rand() % 2) c = ' ';
+                }
+            }
+        }
+        fuzz_one(buf, n);
+    }
+
+    printf("fuzz: %lu iterations OK\n", iterations);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0)
+        return run_bench(argc >= 3 ? strtoul(argv[2], NULL, 10) : 2000000);
+    if (argc >= 2 && strcmp(argv[1], "fuzz") == 0)
+        return run_fuzz(argc >= 3 ? strtoul(argv[2], NULL, 10) : 200000);
+
+    fprintf(stderr, "usage: %s bench [lines] | fuzz [iterations]\n", argv[0]);
+    return 2;
+}
+#endif
@@ -0,0 +1,190 @@
+// ==========================
+//  SERIAL RECORDING ROUND-TRIP TEST
+//
+//  gcc -O2 record_test.c aurum_record.c aurum_protocol.c -o record_test
+//  ./record_test
+//
+//  Feeds byte streams to the recorder in awkward chunks (CR-only, "\r\n"
+//  split across reads, LF-only, over-long lines), reads the file back and
+//  checks the records, their times, and that the parser sees the same
+//  events from the replayed records as from the original stream.
+// ==========================
+
+#include "aurum_record.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: " __VA_ARGS__); fputc('\n', stderr); return 1; } \
+} while (0)
+
+// One read() as the serial thread saw it
+typedef struct {
+    const char *data;
+    int64_t t_us;
+} Chunk;
+
+// What the file must hold, in order
+typedef struct {
+    const char *line;
+    int64_t t_us;
+} Want;
+
+static void count_event(const AurumEvent *ev, void *user)
+{
+    (void)ev;
+    (*(unsigned long *)user)++;
+}
+
+static unsigned long parse_count(const char *data, size_t n)
+{
+    unsigned long events = 0;
+    AurumParser p;
+    aurum_parser_init(&p, AURUM_DIALECT_TTY5 | AURUM_DIALECT_STM, count_event, &events);
+    aurum_parser_feed(&p, data, n);
+    return events;
+}
+
+static void *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    static char buf[1 << 16];
+
+    if (!f)
+        return NULL;
+    *len = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    return buf;
+}
+
+// Record chunks into a fresh file, read it back, compare with want[]
+static int round_trip(const char *name, const Chunk *chunks, const Want *want)
+{
+    char path[] = "/tmp/record_test.XXXXXX";
+    int fd = mkstemp(path);
+    AurumRecorder r;
+    static char stream[1 << 16], replayed[1 << 16];
+    size_t stream_len = 0, replayed_len = 0;
+
+    CHECK(fd >= 0, "%s: mkstemp", name);
+    close(fd);
+    CHECK(aurum_recorder_open(&r, path, 1000, 42) == 0, "%s: open", name);
+
+    for (const Chunk *c = chunks; c->data; c++) {
+        size_t n = strlen(c->data);
+        aurum_recorder_feed(&r, c->data, n, c->t_us);
+        memcpy(stream + stream_len, c->data, n);
+        stream_len += n;
+    }
+    aurum_recorder_close(&r);
+    CHECK(r.errors == 0, "%s: %lu write errors", name, r.errors);
+
+    size_t len;
+    void *buf = read_file(path, &len);
+    AurumRecordReader rd;
+    AurumRecord rec;
+    unlink(path);
+    CHECK(buf && aurum_record_reader_init(&rd, buf, len) == 0, "%s: header", name);
+    CHECK(aurum_record_next(&rd, &rec) == AURUM_REC_SESSION &&
+          rec.t_us == 1000 && rec.wall_us == 42, "%s: session record", name);
+
+    int i = 0;
+    while (aurum_record_next(&rd, &rec) == AURUM_REC_LINE) {
+        CHECK(want[i].line, "%s: extra record %d", name, i);
+        CHECK(rec.len == strlen(want[i].line) &&
+              memcmp(rec.data, want[i].line, rec.len) == 0,
+              "%s: record %d is \"%.*s\"", name, i, (int)rec.len, rec.data);
+        CHECK(rec.t_us == want[i].t_us, "%s: record %d at %lld us, wanted %lld",
+              name, i, (long long)rec.t_us, (long long)want[i].t_us);
+        memcpy(replayed + replayed_len, rec.data, rec.len);
+        replayed_len += rec.len;
+        i++;
+    }
+    CHECK(rec.type == AURUM_REC_END, "%s: file corrupt after record %d", name, i);
+    CHECK(!want[i].line, "%s: %d records, wanted more", name, i);
+
+    // Replay reproduces the stream byte for byte, so the parser agrees
+    CHECK(replayed_len == stream_len && memcmp(replayed, stream, stream_len) == 0,
+          "%s: replayed bytes differ", name);
+    unsigned long events = parse_count(stream, stream_len);
+    CHECK(parse_count(replayed, replayed_len) == events, "%s: parser disagrees", name);
+
+    printf("%-12s %d records, %lu events OK\n", name, i, events);
+    return 0;
+}
+
+// ===================== SCENARIOS =====================
+static int test_cr_only(void)
+{
+    static const Chunk in[] = {
+        { ":01 1 5\r:01 1 6\r", 2000 },     // CR ends the chunk
+        { ":01 1 7\r", 3000 },
+        { ":00 3 7A\r:01", 4000 },
+        { " 1 8\r", 5000 },                 // last CR of the stream
+        { NULL, 0 },
+    };
+    static const Want want[] = {
+        { ":01 1 5\r", 2000 }, { ":01 1 6\r", 2000 }, { ":01 1 7\r", 3000 },
+        { ":00 3 7A\r", 4000 }, { ":01 1 8\r", 5000 }, { NULL, 0 },
+    };
+    return round_trip("cr-only", in, want);
+}
+
+static int test_crlf(void)
+{
+    static const Chunk in[] = {
+        { ":01 1 5\r\n:01 1 6\r", 2000 },
+        { "\n:01 1 7\r", 3000 },            // "\r\n" split across reads
+        { ":01 1 8\r\n", 4000 },            // CR then a new line, not '\n'
+        { "\r", 5000 },
+        { "\n", 6000 },
+        { NULL, 0 },
+    };
+    static const Want want[] = {
+        { ":01 1 5\r\n", 2000 }, { ":01 1 6\r\n", 2000 }, { ":01 1 7\r", 3000 },
+        { ":01 1 8\r\n", 4000 }, { "\r\n", 5000 }, { NULL, 0 },
+    };
+    return round_trip("crlf", in, want);
+}
+
+static int test_lf_only(void)
+{
+    static const Chunk in[] = {
+        { ":01 1 5\n:01", 2000 },
+        { " 1 6\n", 3000 },
+        { ":01 1 7", 4000 },                // never terminated
+        { NULL, 0 },
+    };
+    static const Want want[] = {
+        { ":01 1 5\n", 2000 }, { ":01 1 6\n", 3000 }, { ":01 1 7", 3000 },
+        { NULL, 0 },
+    };
+    return round_trip("lf-only", in, want);
+}
+
+// A line longer than AURUM_LINE_MAX is cut into full-buffer records
+static int test_long_line(void)
+{
+    static char lng[AURUM_LINE_MAX + 11];
+    static char head[AURUM_LINE_MAX + 1];
+    memset(lng, 'x', AURUM_LINE_MAX + 8);
+    memcpy(lng + AURUM_LINE_MAX + 8, "\r\n", 3);
+    memcpy(head, lng, AURUM_LINE_MAX);
+
+    const Chunk in[] = { { lng, 2000 }, { ":01 1 5\r", 3000 }, { NULL, 0 } };
+    const Want want[] = {
+        { head, 2000 }, { "xxxxxxxx\r\n", 2000 }, { ":01 1 5\r", 3000 }, { NULL, 0 },
+    };
+    return round_trip("long-line", in, want);
+}
+
+int main(void)
+{
+    if (test_cr_only() || test_crlf() || test_lf_only() || test_long_line())
+        return 1;
+    printf("all recording tests passed\n");
+    return 0;
+}
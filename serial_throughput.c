@@ -0,0 +1,199 @@
+// ==========================
+//  SERIAL THROUGHPUT TEST (pty pair)
+//
+//  gcc -O2 -pthread serial_throughput.c aurum_serial.c aurum_protocol.c -o serial_throughput
+//  ./serial_throughput [rounds]
+//
+//  A writer thread replays a full 90-number game plus control traffic into
+//  the pty master; the slave side is opened with aurum_serial_open() and
+//  read the way the kiosk does (poll + parser). A pty ignores the baud
+//  rate, so the measured figure is the host-side ceiling; the table below
+//  it gives the wire time of the same replay on a real UART.
+// ==========================
+
+#define _GNU_SOURCE
+#include "aurum_protocol.h"
+#include "aurum_serial.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ===================== REPLAY SCRIPT =====================
+// One game: start, 90 numbers with a "$N" slot update after each, game over
+static size_t build_game(char *buf, size_t cap)
+{
+    size_t len = 0;
+
+    len += snprintf(buf + len, cap - len, "$M GS\r\n");
+    for (int n = 1; n <= AURUM_NUMBER_MAX; n++) {
+        len += snprintf(buf + len, cap - len, ":01 1 %d\r\n", n);
+        len += snprintf(buf + len, cap - len, "$N %d %d %d\r\n",
+                        n, n > 1 ? n - 1 : 0, n > 2 ? n - 2 : 0);
+    }
+    len += snprintf(buf + len, cap - len, "$M G1\r\n");
+    return len;
+}
+
+typedef struct {
+    int fd;
+    const char *buf;
+    size_t len;
+    unsigned long rounds;
+} Writer;
+
+static void *writer_thread(void *arg)
+{
+    Writer *w = arg;
+
+    for (unsigned long r = 0; r < w->rounds; r++) {
+        size_t off = 0;
+        while (off < w->len) {
+            ssize_t n = write(w->fd, w->buf + off, w->len - off);
+            if (n < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                perror("pty write");
+                return NULL;
+            }
+            off += (size_t)n;
+        }
+    }
+    return NULL;
+}
+
+static void count_event(const AurumEvent *ev, void *user)
+{
+    (void)ev;
+    (*(unsigned long *)user)++;
+}
+
+// ===================== AUTO-BAUD SELF-CHECK =====================
+#define SNAP_REPLY "$S 12 11 10 12 1 2 3 4 5 6 7 8 9 10 11 12\r\n"
+
+// Answer "snap" with a snapshot like the controller does
+static void *responder_thread(void *arg)
+{
+    int fd = *(int *)arg;
+    char buf[64];
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    if (poll(&pfd, 1, 2000) > 0 && read(fd, buf, sizeof(buf)) > 0)
+        write(fd, SNAP_REPLY, strlen(SNAP_REPLY));
+    return NULL;
+}
+
+static int open_pty_pair(int *master, AurumSerialConfig *cfg)
+{
+    *master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (*master < 0 || grantpt(*master) < 0 || unlockpt(*master) < 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+
+    // Raw master side too, so "\r\n" is not rewritten by the line discipline
+    struct termios t;
+    tcgetattr(*master, &t);
+    cfmakeraw(&t);
+    tcsetattr(*master, TCSANOW, &t);
+
+    aurum_serial_config_defaults(cfg);
+    snprintf(cfg->port, sizeof(cfg->port), "%s", ptsname(*master));
+    return aurum_serial_open(cfg);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long rounds = argc >= 2 ? strtoul(argv[1], NULL, 10) : 2000;
+    AurumSerialConfig cfg;
+    int master;
+
+    // ---------------- Auto-baud against a fake controller ----------------
+    int slave = open_pty_pair(&master, &cfg);
+    if (slave < 0)
+        return 1;
+
+    pthread_t resp;
+    pthread_create(&resp, NULL, responder_thread, &master);
+    char reply[AURUM_LINE_MAX];
+    size_t reply_len;
+    int baud = aurum_serial_autobaud(slave, NULL, 0, "snap\r\n", 300, AURUM_DIALECT_TTY5,
+                                     reply, sizeof(reply), &reply_len);
+    pthread_join(resp, NULL);
+
+    // The reply that settled the rate must reach the caller intact
+    unsigned long handed = 0;
+    AurumParser caller;
+    aurum_parser_init(&caller, AURUM_DIALECT_TTY5, count_event, &handed);
+    aurum_parser_feed(&caller, reply, reply_len);
+    printf("auto-baud probe: %s (detected %d, %lu event handed back)\n",
+           baud > 0 && handed == 1 ? "OK" : "FAIL", baud, handed);
+    close(slave);
+    close(master);
+    if (baud <= 0 || handed != 1)
+        return 1;
+
+    // ---------------- Throughput ----------------
+    slave = open_pty_pair(&master, &cfg);
+    if (slave < 0)
+        return 1;
+
+    static char game[8192];
+    size_t game_len = build_game(game, sizeof(game));
+
+    unsigned long events = 0;
+    AurumParser parser;
+    aurum_parser_init(&parser, AURUM_DIALECT_STM, count_event, &events);
+
+    Writer w = { master, game, game_len, rounds };
+    unsigned long total = game_len * rounds;
+    unsigned long got = 0;
+    char rbuf[4096];
+
+    double t0 = now_sec();
+    pthread_t wt;
+    pthread_create(&wt, NULL, writer_thread, &w);
+
+    struct pollfd pfd = { .fd = slave, .events = POLLIN };
+    while (got < total) {
+        if (poll(&pfd, 1, 2000) <= 0) {
+            fprintf(stderr, "timeout after %lu of %lu bytes\n", got, total);
+            break;
+        }
+        ssize_t n = read(slave, rbuf, sizeof(rbuf));
+        if (n > 0) {
+            aurum_parser_feed(&parser, rbuf, (size_t)n);
+            got += (unsigned long)n;
+        }
+    }
+    double dt = now_sec() - t0;
+    pthread_join(wt, NULL);
+
+    printf("pty: %lu bytes, %lu lines, %lu events in %.3f s\n",
+           got, parser.lines, events, dt);
+    printf("pty: %.2f MB/s  %.0f lines/s  (one game = %zu bytes, %.1f us)\n",
+           got / dt / 1e6, parser.lines / dt, game_len, dt / rounds * 1e6);
+
+    // ---------------- Wire time of one game per baud (8N1) ----------------
+    static const int bauds[] = { 9600, 19200, 57600, 115200, 230400, 460800, 921600 };
+    printf("\n  baud     one game on the wire\n");
+    for (size_t i = 0; i < sizeof(bauds) / sizeof(bauds[0]); i++)
+        printf("%7d  %8.1f ms\n", bauds[i], game_len * 10.0 / bauds[i] * 1000);
+
+    close(slave);
+    close(master);
+    return got == total ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// ==========================
+//  TILE PIXEL FORMAT BENCH
+//
+//  gcc -O2 tile_format_bench.c aurum_tile.c aurum_layout.c -o tile_format_bench `pkg-config --cflags --libs pangocairo`
+//  ./tile_format_bench [WIDTH HEIGHT [FRAMES]]      (default 1920 1080 300)
+//
+//  For each AURUM_PIXEL_FORMAT, renders the kiosk's three token tiles at
+//  the screen size and composites them onto an XRGB screen surface the
+//  way compositor_draw does. Reports tile memory, render time, composite
+//  time and the bytes read per frame. "argb32+pixbuf" is the old path:
+//  ARGB32 tiles un-premultiplied into a GdkPixbuf-style RGBA buffer.
+// ==========================
+
+#include "aurum_tile.h"
+#include "aurum_layout.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+typedef cairo_rectangle_int_t Rect;
+
+// What gdk_pixbuf_get_from_surface does for ARGB32: un-premultiply to RGBA
+static void unpremultiply(cairo_surface_t *s, uint8_t *out)
+{
+    int w = cairo_image_surface_get_width(s);
+    int h = cairo_image_surface_get_height(s);
+    int stride = cairo_image_surface_get_stride(s);
+    const uint8_t *data = cairo_image_surface_get_data(s);
+
+    for (int y = 0; y < h; y++) {
+        const uint32_t *src = (const uint32_t *)(data + (size_t)y * stride);
+        for (int x = 0; x < w; x++) {
+            uint32_t p = src[x];
+            unsigned a = p >> 24;
+            uint8_t *o = out + ((size_t)y * w + x) * 4;
+            if (a == 0) {
+                o[0] = o[1] = o[2] = o[3] = 0;
+                continue;
+            }
+            o[0] = (uint8_t)((((p >> 16) & 0xff) * 255 + a / 2) / a);
+            o[1] = (uint8_t)((((p >> 8) & 0xff) * 255 + a / 2) / a);
+            o[2] = (uint8_t)(((p & 0xff) * 255 + a / 2) / a);
+            o[3] = (uint8_t)a;
+        }
+    }
+}
+
+static void run(const char *name, cairo_format_t format, int pixbuf,
+                int W, int H, int frames)
+{
+    AurumTileRenderer r;
+    AurumLayout l;
+    cairo_surface_t *tiles[AURUM_TILE_SLOTS];
+    size_t tile_bytes = 0;
+
+    aurum_tile_renderer_init(&r);
+    r.format = format;
+    aurum_layout_compute(&l, &aurum_layout_default_ratios, W, H);
+    const Rect *tile = l.tile;
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+        aurum_tile_prepare(&r, &aurum_tile_styles[s], 1, tile[s].width, tile[s].height);
+
+    // Render: one tile set per number, as a token stream would
+    int64_t t0 = now_us();
+    for (int n = 1; n <= 90; n++) {
+        char text[4];
+        snprintf(text, sizeof(text), "%d", n);
+        for (int s = 0; s < AURUM_TILE_SLOTS; s++) {
+            cairo_surface_t *t = aurum_tile_render(&r, tile[s].width, tile[s].height, text,
+                                                   &aurum_tile_styles[s], 1);
+            if (pixbuf) {
+                uint8_t *rgba = malloc((size_t)tile[s].width * tile[s].height * 4);
+                unpremultiply(t, rgba);
+                free(rgba);
+            }
+            cairo_surface_destroy(t);
+        }
+    }
+    double render_ms = (now_us() - t0) / 1000.0 / 90;
+
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++) {
+        tiles[s] = aurum_tile_render(&r, tile[s].width, tile[s].height, "88",
+                                     &aurum_tile_styles[s], 1);
+        tile_bytes += (size_t)cairo_image_surface_get_stride(tiles[s]) * tile[s].height;
+    }
+
+    // Composite: the three tiles onto an XRGB window surface, every frame
+    cairo_surface_t *screen = cairo_image_surface_create(CAIRO_FORMAT_RGB24, W, H);
+    cairo_t *cr = cairo_create(screen);
+    t0 = now_us();
+    for (int f = 0; f < frames; f++) {
+        for (int s = 0; s < AURUM_TILE_SLOTS; s++) {
+            cairo_set_source_surface(cr, tiles[s], tile[s].x, tile[s].y);
+            cairo_rectangle(cr, tile[s].x, tile[s].y, tile[s].width, tile[s].height);
+            cairo_fill(cr);
+        }
+    }
+    cairo_surface_flush(screen);
+    double blit_ms = (now_us() - t0) / 1000.0 / frames;
+
+    printf("%-14s %8.1f MB %10.2f ms %10.2f ms %10.1f MB %9.2f GB/s\n",
+           name, tile_bytes / 1048576.0 * 91, render_ms, blit_ms,
+           tile_bytes / 1048576.0, tile_bytes / (blit_ms / 1000.0) / 1e9);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(screen);
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+        cairo_surface_destroy(tiles[s]);
+    aurum_tile_renderer_free(&r);
+}
+
+int main(int argc, char *argv[])
+{
+    int W = 1920, H = 1080, frames = 300;
+
+    if (argc >= 3) {
+        W = atoi(argv[1]);
+        H = atoi(argv[2]);
+    }
+    if (argc >= 4)
+        frames = atoi(argv[3]);
+    if (W < 320 || H < 240 || frames < 1) {
+        fprintf(stderr, "usage: %s [WIDTH HEIGHT [FRAMES]]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%dx%d, 90 tile sets rendered, %d frames composited\n\n", W, H, frames);
+    printf("%-14s %11s %13s %13s %13s %14s\n", "format", "full cache",
+           "render/set", "blit/frame", "read/frame", "blit rate");
+
+    run("argb32+pixbuf", CAIRO_FORMAT_ARGB32, 1, W, H, frames);
+    run("argb32", CAIRO_FORMAT_ARGB32, 0, W, H, frames);
+    run("rgb24", CAIRO_FORMAT_RGB24, 0, W, H, frames);
+    return 0;
+}
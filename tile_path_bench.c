@@ -0,0 +1,159 @@
+// ==========================
+//  TILE PAINT PATH BENCH
+//
+//  gcc -O2 tile_path_bench.c aurum_tile.c aurum_layout.c -o tile_path_bench `pkg-config --cflags --libs gdk-3.0 pangocairo`
+//  ./tile_path_bench [WIDTH HEIGHT [UPDATES]]      (default 1920 1080 200)
+//
+//  Times one token update (three tiles) through the old GtkImage path and
+//  the direct surface paint the kiosk uses now, with the real gdk calls:
+//    pixbuf   render -> gdk_pixbuf_get_from_surface -> the pixbuf-to-
+//             surface upload GtkImage does when it draws -> paint
+//    miss     render -> paint                  (tile not cached yet)
+//    hit      paint                            (tile from the cache)
+//  Reports the time per update and the bytes each path reads and writes,
+//  counted from the real buffer strides, also as full passes over the
+//  three tiles, and how many times faster the direct paths are.
+// ==========================
+
+#include "aurum_tile.h"
+#include "aurum_layout.h"
+
+#include <gdk/gdk.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+typedef cairo_rectangle_int_t Rect;
+
+typedef enum { PATH_PIXBUF, PATH_MISS, PATH_HIT } Path;
+
+static const char *const path_names[] = { "pixbuf", "miss", "hit" };
+
+static void paint(cairo_t *cr, cairo_surface_t *s, const Rect *r)
+{
+    cairo_save(cr);
+    cairo_rectangle(cr, r->x, r->y, r->width, r->height);
+    cairo_clip(cr);
+    cairo_set_source_surface(cr, s, r->x, r->y);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+// Bytes in one pass over the three tiles: the unit of the "passes" column
+static double tile_pass_bytes(const Rect tile[AURUM_TILE_SLOTS])
+{
+    double bytes = 0;
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+        bytes += (double)cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, tile[s].width) *
+                 tile[s].height;
+    return bytes;
+}
+
+// Returns ms per update
+static double run(Path path, AurumTileRenderer *r, const Rect tile[AURUM_TILE_SLOTS],
+                  cairo_t *screen, int updates)
+{
+    cairo_surface_t *cached[AURUM_TILE_SLOTS];
+    double bytes = 0;
+
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+        cached[s] = aurum_tile_render(r, tile[s].width, tile[s].height, "88",
+                                      &aurum_tile_styles[s], 1);
+
+    int64_t t0 = now_us();
+    for (int i = 0; i < updates; i++) {
+        char text[4];
+        snprintf(text, sizeof(text), "%d", i % 90 + 1);
+
+        for (int s = 0; s < AURUM_TILE_SLOTS; s++) {
+            const Rect *t = &tile[s];
+            double surface = (double)cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32,
+                                                                   t->width) * t->height;
+
+            if (path == PATH_HIT) {
+                paint(screen, cached[s], t);
+                bytes += surface;                           // read tile
+                continue;
+            }
+
+            cairo_surface_t *out = aurum_tile_render(r, t->width, t->height, text,
+                                                     &aurum_tile_styles[s], 1);
+            bytes += surface;                               // write tile
+
+            if (path == PATH_PIXBUF) {
+                GdkPixbuf *pb = gdk_pixbuf_get_from_surface(out, 0, 0, t->width, t->height);
+                double pixbuf = (double)gdk_pixbuf_get_rowstride(pb) * t->height;
+                cairo_surface_destroy(out);
+                bytes += surface + pixbuf;                  // un-premultiply copy
+
+                out = gdk_cairo_surface_create_from_pixbuf(pb, 1, NULL);
+                bytes += pixbuf + surface;                  // GtkImage upload
+                g_object_unref(pb);
+            }
+
+            paint(screen, out, t);
+            bytes += surface;                               // read for paint
+            cairo_surface_destroy(out);
+        }
+        cairo_surface_flush(cairo_get_target(screen));
+    }
+    double ms = (now_us() - t0) / 1000.0 / updates;
+
+    printf("%-8s %12.2f ms %12.1f MB %8.1f\n", path_names[path], ms,
+           bytes / updates / 1048576.0, bytes / updates / tile_pass_bytes(tile));
+
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+        cairo_surface_destroy(cached[s]);
+    return ms;
+}
+
+int main(int argc, char *argv[])
+{
+    int W = 1920, H = 1080, updates = 200;
+
+    if (argc >= 3) {
+        W = atoi(argv[1]);
+        H = atoi(argv[2]);
+    }
+    if (argc >= 4)
+        updates = atoi(argv[3]);
+    if (W < 320 || H < 240 || updates < 1) {
+        fprintf(stderr, "usage: %s [WIDTH HEIGHT [UPDATES]]\n", argv[0]);
+        return 2;
+    }
+
+    AurumTileRenderer r;
+    AurumLayout l;
+
+    aurum_tile_renderer_init(&r);
+    r.format = CAIRO_FORMAT_ARGB32;     // what the pixbuf path rendered
+    aurum_layout_compute(&l, &aurum_layout_default_ratios, W, H);
+    const Rect *tile = l.tile;
+    for (int s = 0; s < AURUM_TILE_SLOTS; s++)
+        aurum_tile_prepare(&r, &aurum_tile_styles[s], 1, tile[s].width, tile[s].height);
+
+    cairo_surface_t *target = cairo_image_surface_create(CAIRO_FORMAT_RGB24, W, H);
+    cairo_t *screen = cairo_create(target);
+
+    printf("%dx%d, %d token updates of three tiles\n\n", W, H, updates);
+    printf("%-8s %15s %15s %8s\n", "path", "time/update", "traffic/update", "passes");
+    double pixbuf_ms = run(PATH_PIXBUF, &r, tile, screen, updates);
+    double miss_ms = run(PATH_MISS, &r, tile, screen, updates);
+    double hit_ms = run(PATH_HIT, &r, tile, screen, updates);
+    printf("\ndirect paint vs pixbuf: miss %.1fx, hit %.1fx faster per update\n",
+           pixbuf_ms / miss_ms, pixbuf_ms / hit_ms);
+
+    cairo_destroy(screen);
+    cairo_surface_destroy(target);
+    aurum_tile_renderer_free(&r);
+    return 0;
+}
@@ -0,0 +1,381 @@
+// ==========================
+//  VT SWITCH MANAGER TEST
+//
+//  gcc -O2 -pthread vt_switch_test.c aurum_vt.c -o vt_switch_test
+//  ./vt_switch_test                 run against a fake console device
+//  sudo ./vt_switch_test /dev/tty0 5 1
+//                                   real switches (to tty5, then tty1)
+// ==========================
+
+#include "aurum_vt.h"
+
+#include <errno.h>
+#include <linux/vt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static int64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ===================== FAKE CONSOLE =====================
+// VT_ACTIVATE starts a switch that completes switch_delay_us later
+// (never, with stuck: a VT_PROCESS owner that does not release);
+// VT_WAITACTIVE blocks until it has, like the kernel does.
+typedef struct {
+    pthread_mutex_t lock;
+    int active;
+    int target;
+    int64_t done_at_us;
+    int64_t switch_delay_us;
+    int deny_activate;      // VT_ACTIVATE fails with EPERM
+    int stuck;              // accepted switches never complete
+    int fail_open;
+    unsigned long activates;
+    unsigned long getstates;
+} FakeConsole;
+
+static void fake_settle(FakeConsole *c)
+{
+    if (c->target && !c->stuck && now_us() >= c->done_at_us) {
+        c->active = c->target;
+        c->target = 0;
+    }
+}
+
+static int fake_open(void *ctx, const char *path)
+{
+    FakeConsole *c = ctx;
+    (void)path;
+    if (c->fail_open) {
+        errno = ENOENT;
+        return -1;
+    }
+    return 1000;
+}
+
+static int fake_ioctl(void *ctx, int fd, unsigned long request, unsigned long arg)
+{
+    FakeConsole *c = ctx;
+    int ret = 0;
+
+    if (fd != 1000) {
+        errno = EBADF;
+        return -1;
+    }
+
+    pthread_mutex_lock(&c->lock);
+    fake_settle(c);
+
+    switch (request) {
+    case VT_ACTIVATE:
+        if (c->deny_activate) {
+            errno = EPERM;
+            ret = -1;
+            break;
+        }
+        c->activates++;
+        if ((int)arg != c->active) {
+            c->target = (int)arg;
+            c->done_at_us = now_us() + c->switch_delay_us;
+        }
+        break;
+
+    case VT_WAITACTIVE:
+        while (c->active != (int)arg) {
+            if (!c->target) {
+                errno = EINVAL;   // nothing in flight would ever satisfy it
+                ret = -1;
+                break;
+            }
+            pthread_mutex_unlock(&c->lock);
+            usleep(200);
+            pthread_mutex_lock(&c->lock);
+            fake_settle(c);
+        }
+        break;
+
+    case VT_GETSTATE: {
+        struct vt_stat *st = (struct vt_stat *)arg;
+        c->getstates++;
+        memset(st, 0, sizeof(*st));
+        st->v_active = (unsigned short)c->active;
+        break;
+    }
+
+    default:
+        errno = ENOTTY;
+        ret = -1;
+    }
+
+    pthread_mutex_unlock(&c->lock);
+    return ret;
+}
+
+static void fake_close(void *ctx, int fd)
+{
+    (void)ctx;
+    (void)fd;
+}
+
+// ===================== RESULT COLLECTION =====================
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    unsigned long done;
+    int last_vt;
+    AurumVtResult last_result;
+    int64_t total_us;       // request -> confirmed
+    int64_t max_us;
+} Results;
+
+static const char *result_name(AurumVtResult r)
+{
+    switch (r) {
+    case AURUM_VT_OK:       return "ok";
+    case AURUM_VT_FALLBACK: return "fallback";
+    default:                return "failed";
+    }
+}
+
+static void on_done(int vt, AurumVtResult r, int64_t queued_us,
+                    int64_t switch_us, void *user)
+{
+    Results *res = user;
+
+    pthread_mutex_lock(&res->lock);
+    res->done++;
+    res->last_vt = vt;
+    res->last_result = r;
+    res->total_us += queued_us + switch_us;
+    if (queued_us + switch_us > res->max_us)
+        res->max_us = queued_us + switch_us;
+    pthread_cond_signal(&res->cond);
+    pthread_mutex_unlock(&res->lock);
+}
+
+static void wait_done(Results *res, unsigned long n)
+{
+    pthread_mutex_lock(&res->lock);
+    while (res->done < n)
+        pthread_cond_wait(&res->cond, &res->lock);
+    pthread_mutex_unlock(&res->lock);
+}
+
+static void results_init(Results *res)
+{
+    memset(res, 0, sizeof(*res));
+    pthread_mutex_init(&res->lock, NULL);
+    pthread_cond_init(&res->cond, NULL);
+}
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: " __VA_ARGS__); fputc('\n', stderr); return 1; } \
+} while (0)
+
+// ===================== SCENARIOS =====================
+static void fake_init(FakeConsole *c, AurumVtOps *ops)
+{
+    memset(c, 0, sizeof(*c));
+    pthread_mutex_init(&c->lock, NULL);
+    c->active = 1;
+    c->switch_delay_us = 2000;
+
+    ops->open = fake_open;
+    ops->ioctl = fake_ioctl;
+    ops->close = fake_close;
+    ops->ctx = c;
+}
+
+// Overlay transitions as the kiosk issues them; each confirmed in turn
+static int test_sequence(void)
+{
+    static const int seq[] = { 5, 1, 2, 1, 4, 1, 5, 1 };
+    const unsigned long n = sizeof(seq) / sizeof(seq[0]);
+    FakeConsole c;
+    AurumVtOps ops;
+    AurumVt vt;
+    Results res;
+
+    fake_init(&c, &ops);
+    results_init(&res);
+    CHECK(aurum_vt_init(&vt, "fake", &ops, on_done, &res) == 0, "init");
+
+    int64_t t0 = now_us();
+    for (unsigned long i = 0; i < n; i++) {
+        int64_t r0 = now_us();
+        aurum_vt_switch(&vt, seq[i]);
+        CHECK(now_us() - r0 < 1000, "aurum_vt_switch blocked the caller");
+        wait_done(&res, i + 1);
+        CHECK(res.last_result == AURUM_VT_OK, "switch to %d: %s",
+              seq[i], result_name(res.last_result));
+        CHECK(aurum_vt_active(&vt) == seq[i], "active %d, wanted %d",
+              aurum_vt_active(&vt), seq[i]);
+    }
+    int64_t dt = now_us() - t0;
+    aurum_vt_shutdown(&vt);
+
+    printf("sequence: %lu switches OK, mean %.2f ms, max %.2f ms "
+           "(fake switch delay %.1f ms), %.1f ms total\n",
+           n, res.total_us / 1000.0 / n, res.max_us / 1000.0,
+           c.switch_delay_us / 1000.0, dt / 1000.0);
+    return 0;
+}
+
+// Requests that pile up behind a slow switch collapse to the latest one
+static int test_coalesce(void)
+{
+    FakeConsole c;
+    AurumVtOps ops;
+    AurumVt vt;
+    Results res;
+
+    fake_init(&c, &ops);
+    c.switch_delay_us = 50000;
+    results_init(&res);
+    CHECK(aurum_vt_init(&vt, "fake", &ops, on_done, &res) == 0, "init");
+
+    aurum_vt_switch(&vt, 2);
+    usleep(5000);                   // worker is now inside the 50 ms switch
+    aurum_vt_switch(&vt, 5);
+    aurum_vt_switch(&vt, 4);
+    aurum_vt_switch(&vt, 1);
+    wait_done(&res, 2);
+    aurum_vt_shutdown(&vt);
+
+    CHECK(res.done == 2, "%lu switches ran, wanted 2", res.done);
+    CHECK(c.active == 1 && res.last_vt == 1, "ended on VT %d", c.active);
+    CHECK(vt.coalesced == 2, "coalesced %lu, wanted 2", vt.coalesced);
+    printf("coalesce: 4 requests -> %lu switches, ended on VT %d OK\n",
+           res.done, c.active);
+    return 0;
+}
+
+// No permission for VT_ACTIVATE, or no console at all: run the command
+static int test_fallback(int fail_open)
+{
+    FakeConsole c;
+    AurumVtOps ops;
+    AurumVt vt;
+    Results res;
+
+    fake_init(&c, &ops);
+    c.deny_activate = !fail_open;
+    c.fail_open = fail_open;
+    results_init(&res);
+    CHECK(aurum_vt_init(&vt, "fake", &ops, on_done, &res) == 0, "init");
+    vt.fallback_cmd = "test %d -eq 5";          // succeeds for VT 5 only
+
+    aurum_vt_switch(&vt, 5);
+    wait_done(&res, 1);
+    CHECK(res.last_result == AURUM_VT_FALLBACK, "VT 5: %s",
+          result_name(res.last_result));
+    CHECK(vt.fd < 0, "console still in use after fallback");
+
+    aurum_vt_switch(&vt, 1);
+    wait_done(&res, 2);
+    CHECK(res.last_result == AURUM_VT_FAILED, "VT 1: %s",
+          result_name(res.last_result));
+    aurum_vt_shutdown(&vt);
+
+    printf("fallback (%s): OK, %lu fallbacks, %lu failures\n",
+           fail_open ? "open fails" : "EPERM", vt.fallbacks, vt.failures);
+    return 0;
+}
+
+// The switch never completes: give up at the deadline and run the command
+static int test_timeout(void)
+{
+    FakeConsole c;
+    AurumVtOps ops;
+    AurumVt vt;
+    Results res;
+
+    fake_init(&c, &ops);
+    c.stuck = 1;
+    results_init(&res);
+    CHECK(aurum_vt_init(&vt, "fake", &ops, on_done, &res) == 0, "init");
+    vt.switch_timeout_us = 50000;
+    vt.fallback_cmd = "test %d -eq 5";          // succeeds for VT 5 only
+
+    int64_t t0 = now_us();
+    aurum_vt_switch(&vt, 5);
+    wait_done(&res, 1);
+    int64_t dt = now_us() - t0;
+    CHECK(res.last_result == AURUM_VT_FALLBACK, "VT 5: %s",
+          result_name(res.last_result));
+    CHECK(dt >= 50000 && dt < 1000000, "gave up after %.1f ms, wanted ~50",
+          dt / 1000.0);
+    CHECK(vt.fd >= 0, "console dropped after one stuck switch");
+    // Backed-off polling: a handful of checks, not one per millisecond
+    unsigned long polls = c.getstates;
+    CHECK(polls <= 12, "%lu VT_GETSTATE polls in 50 ms", polls);
+
+    aurum_vt_switch(&vt, 2);
+    wait_done(&res, 2);
+    CHECK(res.last_result == AURUM_VT_FAILED, "VT 2: %s",
+          result_name(res.last_result));
+
+    // The command itself hangs: stopped at the deadline too
+    vt.fallback_cmd = "sleep 10 # %d";
+    t0 = now_us();
+    aurum_vt_switch(&vt, 4);
+    wait_done(&res, 3);
+    dt = now_us() - t0;
+    CHECK(res.last_result == AURUM_VT_FAILED, "VT 4: %s",
+          result_name(res.last_result));
+    CHECK(dt < 1000000, "hung command held the worker %.1f ms", dt / 1000.0);
+    aurum_vt_shutdown(&vt);
+
+    CHECK(vt.timeouts == 3, "%lu timeouts, wanted 3", vt.timeouts);
+    printf("timeout: stuck switch gave up in %.1f ms after %lu polls, %lu timeouts, "
+           "%lu fallbacks, %lu failures OK\n", dt / 1000.0, polls, vt.timeouts,
+           vt.fallbacks, vt.failures);
+    return 0;
+}
+
+// ===================== REAL CONSOLE =====================
+static int run_real(const char *console, int argc, char *argv[])
+{
+    AurumVt vt;
+    Results res;
+
+    results_init(&res);
+    if (aurum_vt_init(&vt, console, NULL, on_done, &res) < 0)
+        return 1;
+
+    printf("active VT: %d\n", aurum_vt_active(&vt));
+    for (int i = 0; i < argc; i++) {
+        int64_t before = res.total_us;
+        aurum_vt_switch(&vt, atoi(argv[i]));
+        wait_done(&res, (unsigned long)i + 1);
+        printf("VT %d: %s in %.2f ms\n", res.last_vt,
+               result_name(res.last_result), (res.total_us - before) / 1000.0);
+        if (i + 1 < argc)
+            sleep(1);
+    }
+    aurum_vt_shutdown(&vt);
+    return res.last_result == AURUM_VT_FAILED;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 3)
+        return run_real(argv[1], argc - 2, argv + 2);
+    if (argc != 1) {
+        fprintf(stderr, "usage: %s | %s CONSOLE VT...\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    if (test_sequence() || test_coalesce() ||
+        test_fallback(0) || test_fallback(1) || test_timeout())
+        return 1;
+    printf("all VT manager tests passed\n");
+    return 0;
+}